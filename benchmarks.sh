@@ -21,6 +21,16 @@ source run.sh
 # iterate 20 \
 # run_benchmark
 
+# with_each implementation [ ufo nyc toronto ] \
+# with timing=timing_churn.csv \
+# with benchmark=churn \
+# with churn=100000 \
+# with_each live [ 1 1000 ] \
+# with_each threads [ 1 4 ] \
+# with_each size [ $(:= 1 KB) $(:= 1 MB) ] \
+# iterate 10 \
+# run_benchmark
+
 # 4-16GB 
 # sample 
 
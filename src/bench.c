@@ -5,10 +5,21 @@
 #include <argp.h>
 #include <sys/stat.h>
 #include <locale.h>
+#include <pthread.h>
+#include <math.h>
 
 #include "ufo_c/target/ufo_c.h"
 
 #include "timing.h"
+#include "histogram.h"
+#include "memory.h"
+#include "perf.h"
+#include "stats.h"
+#include "environment.h"
+#include "instrument.h"
+#include "trace.h"
+#include "cgroup.h"
+#include "pagecache.h"
 #include "logging.h"
 #include "random.h"
 
@@ -20,6 +31,10 @@
 
 #include "ufo.h"
 #include "normil.h"
+#include "mmapfile.h"
+#include "tseq.h"
+#include "rep_benchmark.h"
+#include "typed_seq.h"
 #include "nyc.h"
 #include "toronto.h"
 #include "nycpp.h"
@@ -31,6 +46,21 @@ bool file_exists (char *filename) {
   return (stat (filename, &buffer) == 0);
 }
 
+// Splits a comma-separated list in place. Returns the number of items.
+size_t split_list(char *list, char ***items) {
+    size_t count = 1;
+    for (char *c = list; *c != '\0'; c++) {
+        if (*c == ',') count++;
+    }
+    *items = (char **) malloc(sizeof(char *) * count);
+    char *saveptr = NULL;
+    size_t index = 0;
+    for (char *item = strtok_r(list, ",", &saveptr); item != NULL; item = strtok_r(NULL, ",", &saveptr)) {
+        (*items)[index++] = item;
+    }
+    return index;
+}
+
 static error_t parse_opt (int key, char *value, struct argp_state *state) {
     /* Get the input argument from argp_parse, which we
         know is a pointer to our arguments structure. */
@@ -39,227 +69,2594 @@ static error_t parse_opt (int key, char *value, struct argp_state *state) {
         case 'b': arguments->benchmark = value; break;
         case 'i': arguments->implementation = value; break;
         case 'f': arguments->file = value; break;
+        case 'H': arguments->cache_state = value; break;
         case 's': arguments->size = (size_t) atol(value); break;
         case 'm': arguments->min_load = (size_t) atol(value); break;
         case 'h': arguments->high_water_mark = (size_t) atol(value); break;
         case 'l': arguments->low_water_mark = (size_t) atol(value); break;
-        // case 'o': arguments->file = value; break;
+        case 'x': arguments->memory_max = (size_t) atol(value); break;
+        case 'g': arguments->cgroup = value; break;
+        case 'A': arguments->mmapfile_directory = value; break;
+        case 'o': arguments->objects = value; break;
+        case 'q': arguments->quantum = (size_t) atol(value); break;
+        case 'C': arguments->churn_object = value; break;
+        case 'c': arguments->churn = (size_t) atol(value); break;
+        case 'K': arguments->live = (size_t) atol(value); break;
+        case 'y': arguments->population_list = value; break;
+        case 'U': arguments->element = value; break;
+        case 'N': arguments->base = (size_t) atol(value); break;
+        case 'F': arguments->fib_mode_name = value; break;
+        case 'Q': arguments->lookups = (size_t) atol(value); break;
         case 't': arguments->timing = value; break;
-        case 'p': arguments->pattern = value; break;
-        case 'n': arguments->sample_size = (size_t) atol(value); break;
-        case 'w': arguments->writes = (size_t) atol(value); break;
+        case 'p': arguments->pattern_list = value; break;
+        case 'n': arguments->sample_size_list = value; break;
+        case 'w': arguments->writes_list = value; break;
         case 'S': arguments->seed = (unsigned int) atoi(value); break;
+        case 'T': arguments->threads = (size_t) atol(value); break;
+        case 'z': arguments->zipf_exponent = atof(value); break;
+        case 'a': arguments->hot_accesses = atof(value); break;
+        case 'd': arguments->hot_data = atof(value); break;
+        case 'k': arguments->stride = (size_t) atol(value); break;
+        case 'W': arguments->window = (size_t) atol(value); break;
+        case 'L': arguments->latency_sample = (size_t) atol(value); break;
+        case 'M': arguments->memory_sample_interval = (size_t) atol(value); break;
+        case 'P': arguments->perf = atoi(value) != 0; break;
+        case 'r': arguments->repeat = (size_t) atol(value); break;
+        case 'u': arguments->warmup = (size_t) atol(value); break;
+        case 'R': arguments->reuse = atoi(value) != 0; break;
+        case 'O': arguments->summary = value; break;
+        case 'j': arguments->json = value; break;
+        case 'G': arguments->pregenerate = atoi(value) != 0; break;
+        case 'X': arguments->write_mode = value; break;
+        case 'B': arguments->burst = (size_t) atol(value); break;
+        case 'D': arguments->write_region = atof(value); break;
+        case 'V': arguments->write_baseline = atoi(value) != 0; break;
+        case 'I': arguments->instrument = atoi(value) != 0; break;
+        case 'e': arguments->trace = value; break;
+        case 'E': arguments->trace_buffer = (size_t) atol(value); break;
         default:  return ARGP_ERR_UNKNOWN;
     }
     return 0;
 }
 
-// Sequence iterators
-typedef struct { 
-    size_t current; 
-    size_t length; 
-    size_t since_last_write; 
-} ScanSequence;
+// Sequence iterators
+
+// Write modes decide which accesses of a sequence are writes:
+//   * interval: one write every `writes` accesses, zero for read-only,
+//   * only: every access is a write,
+//   * update: one read-modify-write of the same element every `writes` 
+//     accesses, zero for none,
+//   * burst: `burst` consecutive writes at the end of every `writes` accesses,
+//   * hot: like interval, but the written index is folded into the first
+//     `write_region` percent of the object.
+// They are applied to each batch after the pattern generated the indices.
+typedef enum { WRITE_INTERVAL, WRITE_ONLY, WRITE_UPDATE, WRITE_BURST, WRITE_HOT } WriteMode;
+
+static const char *write_mode_names[] = { "interval", "only", "update", "burst", "hot", NULL };
+
+bool write_mode_known(char *write_mode) {
+    for (size_t i = 0; write_mode_names[i] != NULL; i++) {
+        if (strcmp(write_mode_names[i], write_mode) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool config_has_writes(Arguments *config) {
+    return config->writes != 0 || strcmp(config->write_mode, "only") == 0;
+}
+
+// Chunks of min_load elements that were written to at least once, shared by
+// all the workers of a run, and the number of writes they performed.
+typedef struct {
+    size_t chunk;
+    size_t chunks;
+    uint64_t *bitmap;
+    size_t writes;
+} DirtyTracker;
+
+void DirtyTracker_init(DirtyTracker *dirty, size_t chunk, size_t max_length) {
+    dirty->chunk = chunk == 0 ? 1 : chunk;
+    dirty->chunks = (max_length + dirty->chunk - 1) / dirty->chunk;
+    dirty->bitmap = (uint64_t *) calloc((dirty->chunks + 63) / 64 + 1, sizeof(uint64_t));
+    dirty->writes = 0;
+}
+
+size_t DirtyTracker_count(DirtyTracker *dirty) {
+    size_t count = 0;
+    for (size_t i = 0; i < (dirty->chunks + 63) / 64 + 1; i++) {
+        count += __builtin_popcountl(dirty->bitmap[i]);
+    }
+    return count;
+}
+
+void DirtyTracker_free(DirtyTracker *dirty) {
+    free(dirty->bitmap);
+}
+
+static inline void DirtyTracker_mark(DirtyTracker *dirty, size_t index) {
+    size_t chunk = index / dirty->chunk;
+    uint64_t bit = 1UL << (chunk % 64);
+    uint64_t *word = &dirty->bitmap[chunk / 64];
+    if ((__atomic_load_n(word, __ATOMIC_RELAXED) & bit) == 0) {
+        __atomic_fetch_or(word, bit, __ATOMIC_RELAXED);
+    }
+}
+
+typedef struct {
+    WriteMode mode;
+    size_t period;          // Accesses per write cycle, zero for no writes.
+    size_t burst;           // Writes at the end of each cycle.
+    size_t position;        // Position within the current cycle.
+    size_t region_length;   // Hot mode only.
+    DirtyTracker *dirty;
+} WriteSchedule;
+
+void WriteSchedule_init(WriteSchedule *schedule, Arguments *config, size_t max_length, DirtyTracker *dirty) {
+    schedule->mode = WRITE_INTERVAL;
+    for (WriteMode mode = WRITE_INTERVAL; write_mode_names[mode] != NULL; mode++) {
+        if (strcmp(write_mode_names[mode], config->write_mode) == 0) {
+            schedule->mode = mode;
+        }
+    }
+    schedule->period = schedule->mode == WRITE_ONLY ? 1 : config->writes;
+    schedule->burst = schedule->mode == WRITE_BURST ? config->burst : 1;
+    if (schedule->burst > schedule->period) {
+        schedule->burst = schedule->period;
+    }
+    schedule->position = 0;
+    schedule->region_length = (size_t) ceil(((double) max_length) * config->write_region / 100.0);
+    if (schedule->region_length == 0) {
+        schedule->region_length = 1;
+    }
+    schedule->dirty = dirty;
+}
+
+static inline void WriteSchedule_apply(WriteSchedule *schedule, SequenceBatch *batch) {
+    if (schedule->period == 0) {
+        memset(batch->access, ACCESS_READ, batch->length);
+        return;
+    }
+    Access write = schedule->mode == WRITE_UPDATE ? ACCESS_UPDATE : ACCESS_WRITE;
+    size_t first_write = schedule->period - schedule->burst;
+    size_t writes = 0;
+    for (size_t i = 0; i < batch->length; i++) {
+        if (schedule->position >= first_write) {
+            if (schedule->mode == WRITE_HOT) {
+                batch->current[i] %= schedule->region_length;
+            }
+            batch->access[i] = write;
+            if (schedule->dirty != NULL) {
+                DirtyTracker_mark(schedule->dirty, batch->current[i]);
+            }
+            writes++;
+        } else {
+            batch->access[i] = ACCESS_READ;
+        }
+        if (++schedule->position == schedule->period) {
+            schedule->position = 0;
+        }
+    }
+    if (schedule->dirty != NULL) {
+        __atomic_fetch_add(&schedule->dirty->writes, writes, __ATOMIC_RELAXED);
+    }
+}
+
+static inline size_t batch_length(size_t remaining) {
+    return remaining < SEQUENCE_BATCH_SIZE ? remaining : SEQUENCE_BATCH_SIZE;
+}
+
+typedef struct { 
+    size_t current; 
+    size_t end; 
+    WriteSchedule writes;
+} ScanSequence;
+
+size_t ScanSequence_next(Arguments *config, AnySequence sequence, SequenceBatch *batch) {
+    ScanSequence *scan_sequence = (ScanSequence *) sequence;
+    size_t length = batch_length(scan_sequence->end - scan_sequence->current);
+    for (size_t i = 0; i < length; i++) {
+        batch->current[i] = scan_sequence->current + i;
+    }
+    scan_sequence->current += length;
+    batch->length = length;
+    WriteSchedule_apply(&scan_sequence->writes, batch);
+    return length;
+}
+
+typedef struct { 
+    size_t current; 
+    size_t start; 
+    WriteSchedule writes;
+} ReverseSequence;
+
+size_t ReverseSequence_next(Arguments *config, AnySequence sequence, SequenceBatch *batch) {
+    ReverseSequence *reverse_sequence = (ReverseSequence *) sequence;
+    size_t length = batch_length(reverse_sequence->current - reverse_sequence->start);
+    for (size_t i = 0; i < length; i++) {
+        batch->current[i] = reverse_sequence->current - 1 - i;
+    }
+    reverse_sequence->current -= length;
+    batch->length = length;
+    WriteSchedule_apply(&reverse_sequence->writes, batch);
+    return length;
+}
+
+typedef struct { 
+    size_t generated; 
+    size_t length;
+    size_t max_length;
+    WriteSchedule writes;
+} RandomSequence;
+
+size_t RandomSequence_next(Arguments *config, AnySequence sequence, SequenceBatch *batch) {
+    RandomSequence *random_sequence = (RandomSequence *) sequence;
+    size_t length = batch_length(random_sequence->length - random_sequence->generated);
+    for (size_t i = 0; i < length; i++) {
+        batch->current[i] = random_index(random_sequence->max_length);
+    }
+    random_sequence->generated += length;
+    batch->length = length;
+    WriteSchedule_apply(&random_sequence->writes, batch);
+    return length;
+}
+
+// Zipf-distributed indices: the element at index k is accessed with
+// probability proportional to 1/(k+1)^s, so the hottest elements sit at the
+// front of the object. Sampled by rejection-inversion (Hörmann & Derflinger,
+// "Rejection-inversion to generate variates from monotone discrete
+// distributions", 1996). The sampler only needs a handful of constants, which
+// are precomputed when the sequence is created, so there is no O(n) table.
+typedef struct { 
+    size_t generated; 
+    size_t length;
+    size_t max_length;
+    WriteSchedule writes;
+    double exponent;
+    double h_integral_x1;
+    double h_integral_n;
+    double threshold;
+} ZipfSequence;
+
+static double zipf_helper1(double x) {
+    return fabs(x) > 1e-8 ? log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+}
+
+static double zipf_helper2(double x) {
+    return fabs(x) > 1e-8 ? expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+}
+
+static double zipf_h(ZipfSequence *zipf, double x) {
+    return exp(-zipf->exponent * log(x));
+}
+
+static double zipf_h_integral(ZipfSequence *zipf, double x) {
+    double log_x = log(x);
+    return zipf_helper2((1.0 - zipf->exponent) * log_x) * log_x;
+}
+
+static double zipf_h_integral_inverse(ZipfSequence *zipf, double x) {
+    double t = x * (1.0 - zipf->exponent);
+    if (t < -1.0) {
+        t = -1.0; // Numerical safety, t >= -1 analytically.
+    }
+    return exp(zipf_helper1(t) * x);
+}
+
+void ZipfSequence_init(ZipfSequence *zipf, double exponent, size_t max_length) {
+    zipf->exponent = exponent;
+    zipf->max_length = max_length;
+    zipf->h_integral_x1 = zipf_h_integral(zipf, 1.5) - 1.0;
+    zipf->h_integral_n = zipf_h_integral(zipf, ((double) max_length) + 0.5);
+    zipf->threshold = 2.0 - zipf_h_integral_inverse(zipf, zipf_h_integral(zipf, 2.5) - zipf_h(zipf, 2.0));
+}
+
+static inline size_t zipf_index(ZipfSequence *zipf) {
+    while (true) {
+        double u = zipf->h_integral_n + random_uniform() * (zipf->h_integral_x1 - zipf->h_integral_n);
+        double x = zipf_h_integral_inverse(zipf, u);
+        double k = floor(x + 0.5);
+        if (k < 1.0) {
+            k = 1.0;
+        } else if (k > (double) zipf->max_length) {
+            k = (double) zipf->max_length;
+        }
+        if (k - x <= zipf->threshold || u >= zipf_h_integral(zipf, k + 0.5) - zipf_h(zipf, k)) {
+            return ((size_t) k) - 1; // Ranks are 1-based, indices are not.
+        }
+    }
+}
+
+size_t ZipfSequence_next(Arguments *config, AnySequence sequence, SequenceBatch *batch) {
+    ZipfSequence *zipf_sequence = (ZipfSequence *) sequence;
+    size_t length = batch_length(zipf_sequence->length - zipf_sequence->generated);
+    for (size_t i = 0; i < length; i++) {
+        batch->current[i] = zipf_index(zipf_sequence);
+    }
+    zipf_sequence->generated += length;
+    batch->length = length;
+    WriteSchedule_apply(&zipf_sequence->writes, batch);
+    return length;
+}
+
+// Hot-set indices: a fixed fraction of accesses goes to the hot region at the
+// front of the object, the rest is spread uniformly over the cold remainder.
+typedef struct { 
+    size_t generated; 
+    size_t length;
+    size_t hot_length;
+    size_t cold_length;
+    double hot_probability;
+    WriteSchedule writes;
+} HotSetSequence;
+
+size_t HotSetSequence_next(Arguments *config, AnySequence sequence, SequenceBatch *batch) {
+    HotSetSequence *hot_set_sequence = (HotSetSequence *) sequence;
+    size_t length = batch_length(hot_set_sequence->length - hot_set_sequence->generated);
+    for (size_t i = 0; i < length; i++) {
+        if (hot_set_sequence->cold_length == 0 || random_uniform() < hot_set_sequence->hot_probability) {
+            batch->current[i] = random_index(hot_set_sequence->hot_length);
+        } else {
+            batch->current[i] = hot_set_sequence->hot_length + random_index(hot_set_sequence->cold_length);
+        }
+    }
+    hot_set_sequence->generated += length;
+    batch->length = length;
+    WriteSchedule_apply(&hot_set_sequence->writes, batch);
+    return length;
+}
+
+// Strided indices: visits every stride-th element of the slice, then starts
+// over one element further along, until every element was visited once. Each
+// pass touches every chunk, but uses only 1/stride of it.
+typedef struct { 
+    size_t current; 
+    size_t start; 
+    size_t end; 
+    size_t stride; 
+    size_t pass; 
+    WriteSchedule writes;
+} StrideSequence;
+
+size_t StrideSequence_next(Arguments *config, AnySequence sequence, SequenceBatch *batch) {
+    StrideSequence *stride_sequence = (StrideSequence *) sequence;
+    size_t length = 0;
+    while (length < SEQUENCE_BATCH_SIZE) {
+        if (stride_sequence->current >= stride_sequence->end) {
+            stride_sequence->pass++;
+            if (stride_sequence->pass >= stride_sequence->stride 
+                || stride_sequence->start + stride_sequence->pass >= stride_sequence->end) {
+                break;
+            }
+            stride_sequence->current = stride_sequence->start + stride_sequence->pass;
+        }
+        batch->current[length] = stride_sequence->current;
+        stride_sequence->current += stride_sequence->stride;
+        length++;
+    }
+    batch->length = length;
+    WriteSchedule_apply(&stride_sequence->writes, batch);
+    return length;
+}
+
+// Chunk-local random indices: picks a random window that starts at a chunk
+// boundary (every min_load elements) and scans it, then picks another one.
+typedef struct { 
+    size_t generated; 
+    size_t length;
+    size_t max_length;
+    size_t chunk;
+    size_t chunks;
+    size_t window;
+    size_t current; 
+    size_t window_end; 
+    WriteSchedule writes;
+} ChunkRandomSequence;
+
+size_t ChunkRandomSequence_next(Arguments *config, AnySequence sequence, SequenceBatch *batch) {
+    ChunkRandomSequence *chunk_sequence = (ChunkRandomSequence *) sequence;
+    size_t length = batch_length(chunk_sequence->length - chunk_sequence->generated);
+    for (size_t i = 0; i < length; i++) {
+        if (chunk_sequence->current >= chunk_sequence->window_end) {
+            chunk_sequence->current = random_index(chunk_sequence->chunks) * chunk_sequence->chunk;
+            chunk_sequence->window_end = chunk_sequence->current + chunk_sequence->window;
+            if (chunk_sequence->window_end > chunk_sequence->max_length) {
+                chunk_sequence->window_end = chunk_sequence->max_length;
+            }
+        }
+        batch->current[i] = chunk_sequence->current++;
+    }
+    chunk_sequence->generated += length;
+    batch->length = length;
+    WriteSchedule_apply(&chunk_sequence->writes, batch);
+    return length;
+}
+
+static const char *known_patterns[] = { 
+    "scan", "reverse", "random", "stride", "chunk-random", "zipf", "hotset", NULL 
+};
+
+// Whether sequence_new knows the pattern, so --pattern can be checked up front.
+bool pattern_known(char *pattern) {
+    for (size_t i = 0; known_patterns[i] != NULL; i++) {
+        if (strcmp(known_patterns[i], pattern) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Creates an iterator over the slice [start, start + length) of the index
+// sequence. Random patterns only use the length of the slice: they draw
+// `length` indices from the whole [0, max_length) range. Returns NULL if the
+// pattern is unknown.
+AnySequence sequence_new(Arguments *config, size_t start, size_t length, size_t max_length, DirtyTracker *dirty, sequence_t *next) {
+    if (strcmp(config->pattern, "scan") == 0) {
+        ScanSequence *scan_sequence = malloc(sizeof(ScanSequence));
+        scan_sequence->current = start;
+        scan_sequence->end = start + length;
+        WriteSchedule_init(&scan_sequence->writes, config, max_length, dirty);
+        *next = &ScanSequence_next;
+        return (AnySequence) scan_sequence;
+    }
+    if (strcmp(config->pattern, "reverse") == 0) {
+        ReverseSequence *reverse_sequence = malloc(sizeof(ReverseSequence));
+        reverse_sequence->current = start + length;
+        reverse_sequence->start = start;
+        WriteSchedule_init(&reverse_sequence->writes, config, max_length, dirty);
+        *next = &ReverseSequence_next;
+        return (AnySequence) reverse_sequence;
+    }
+    if (strcmp(config->pattern, "random") == 0) {
+        RandomSequence *random_sequence = malloc(sizeof(RandomSequence));
+        random_sequence->generated = 0;
+        random_sequence->length = length;
+        random_sequence->max_length = max_length;
+        WriteSchedule_init(&random_sequence->writes, config, max_length, dirty);
+        *next = &RandomSequence_next;
+        return (AnySequence) random_sequence;
+    }
+    if (strcmp(config->pattern, "stride") == 0) {
+        StrideSequence *stride_sequence = malloc(sizeof(StrideSequence));
+        stride_sequence->current = start;
+        stride_sequence->start = start;
+        stride_sequence->end = start + length;
+        stride_sequence->stride = config->stride;
+        stride_sequence->pass = 0;
+        WriteSchedule_init(&stride_sequence->writes, config, max_length, dirty);
+        *next = &StrideSequence_next;
+        return (AnySequence) stride_sequence;
+    }
+    if (strcmp(config->pattern, "chunk-random") == 0) {
+        ChunkRandomSequence *chunk_sequence = malloc(sizeof(ChunkRandomSequence));
+        chunk_sequence->generated = 0;
+        chunk_sequence->length = length;
+        chunk_sequence->max_length = max_length;
+        chunk_sequence->chunk = config->min_load == 0 ? 1 : config->min_load;
+        chunk_sequence->chunks = (max_length + chunk_sequence->chunk - 1) / chunk_sequence->chunk;
+        chunk_sequence->window = config->window == 0 ? chunk_sequence->chunk : config->window;
+        chunk_sequence->current = 0;
+        chunk_sequence->window_end = 0;
+        WriteSchedule_init(&chunk_sequence->writes, config, max_length, dirty);
+        *next = &ChunkRandomSequence_next;
+        return (AnySequence) chunk_sequence;
+    }
+    if (strcmp(config->pattern, "zipf") == 0) {
+        ZipfSequence *zipf_sequence = malloc(sizeof(ZipfSequence));
+        ZipfSequence_init(zipf_sequence, config->zipf_exponent, max_length);
+        zipf_sequence->generated = 0;
+        zipf_sequence->length = length;
+        WriteSchedule_init(&zipf_sequence->writes, config, max_length, dirty);
+        *next = &ZipfSequence_next;
+        return (AnySequence) zipf_sequence;
+    }
+    if (strcmp(config->pattern, "hotset") == 0) {
+        HotSetSequence *hot_set_sequence = malloc(sizeof(HotSetSequence));
+        hot_set_sequence->generated = 0;
+        hot_set_sequence->length = length;
+        hot_set_sequence->hot_length = (size_t) ceil(((double) max_length) * config->hot_data / 100.0);
+        if (hot_set_sequence->hot_length == 0) {
+            hot_set_sequence->hot_length = 1;
+        }
+        if (hot_set_sequence->hot_length > max_length) {
+            hot_set_sequence->hot_length = max_length;
+        }
+        hot_set_sequence->cold_length = max_length - hot_set_sequence->hot_length;
+        hot_set_sequence->hot_probability = config->hot_accesses / 100.0;
+        WriteSchedule_init(&hot_set_sequence->writes, config, max_length, dirty);
+        *next = &HotSetSequence_next;
+        return (AnySequence) hot_set_sequence;
+    }
+    return NULL;
+}
+
+// Drains another sequence into a buffer up front, so that generating the
+// indices is not part of the timed region. Costs 9 bytes per access.
+typedef struct {
+    size_t position;
+    size_t length;
+    size_t *current;
+    uint8_t *access;
+} PregeneratedSequence;
+
+size_t PregeneratedSequence_next(Arguments *config, AnySequence sequence, SequenceBatch *batch) {
+    PregeneratedSequence *pregenerated_sequence = (PregeneratedSequence *) sequence;
+    size_t length = batch_length(pregenerated_sequence->length - pregenerated_sequence->position);
+    memcpy(batch->current, pregenerated_sequence->current + pregenerated_sequence->position, length * sizeof(size_t));
+    memcpy(batch->access, pregenerated_sequence->access + pregenerated_sequence->position, length * sizeof(uint8_t));
+    pregenerated_sequence->position += length;
+    batch->length = length;
+    return length;
+}
+
+// Takes ownership of the drained sequence and frees it. The buffers are
+// allocated together with the header, so the result is freed with free().
+AnySequence sequence_pregenerate(Arguments *config, AnySequence sequence, sequence_t next, size_t length, sequence_t *pregenerated_next) {
+    PregeneratedSequence *pregenerated_sequence = 
+        malloc(sizeof(PregeneratedSequence) + length * (sizeof(size_t) + sizeof(uint8_t)));
+    if (pregenerated_sequence == NULL) {
+        REPORT("Cannot allocate %lu bytes to pregenerate the index sequence\n", length * (sizeof(size_t) + sizeof(uint8_t)));
+        exit(7);
+    }
+    pregenerated_sequence->position = 0;
+    pregenerated_sequence->length = 0;
+    pregenerated_sequence->current = (size_t *) (pregenerated_sequence + 1);
+    pregenerated_sequence->access = (uint8_t *) (pregenerated_sequence->current + length);
+
+    SequenceBatch batch;
+    while (next(config, sequence, &batch) > 0) {
+        size_t copied = pregenerated_sequence->length + batch.length > length 
+            ? length - pregenerated_sequence->length : batch.length;
+        memcpy(pregenerated_sequence->current + pregenerated_sequence->length, batch.current, copied * sizeof(size_t));
+        memcpy(pregenerated_sequence->access + pregenerated_sequence->length, batch.access, copied * sizeof(uint8_t));
+        pregenerated_sequence->length += copied;
+    }
+    free(sequence);
+
+    *pregenerated_next = &PregeneratedSequence_next;
+    return (AnySequence) pregenerated_sequence;
+}
+
+// Worker threads
+typedef struct {
+    size_t index;
+    Arguments *config;
+    AnySystem system;
+    AnyObject object;
+    execution_t execution;
+    AnySequence sequence;
+    sequence_t next;
+    pthread_barrier_t *barrier;
+    PerfCounters *perf;
+    size_t length;
+    int64_t oubliette;
+    uint64_t start_time;
+    uint64_t elapsed_time;
+    Histogram latencies;
+} Worker;
+
+void *Worker_run(void *argument) {
+    Worker *worker = (Worker *) argument;
+    // Each thread draws from its own stream.
+    random_seed(worker->config->seed + worker->index);
+    if (trace_enabled() && worker->barrier != NULL) {
+        char name[32];
+        snprintf(name, sizeof(name), "worker %lu", worker->index);
+        trace_thread_name(strdup(name));
+    }
+    if (worker->barrier != NULL) {
+        PerfCounters_attach(worker->perf);
+        pthread_barrier_wait(worker->barrier);
+    }
+    worker->start_time = current_time_in_ns();
+    worker->execution(worker->config, worker->system, worker->object, worker->sequence, worker->next, &worker->latencies, &worker->oubliette);
+    worker->elapsed_time = current_time_in_ns() - worker->start_time;
+    return NULL;
+}
+
+// MAX LENGTHS
+size_t fib_max_length(Arguments *config, AnySystem system, AnyObject object) {
+    return config->size;
+}
+size_t bzip_max_length(Arguments *config, AnySystem system, AnyObject object) {
+    BZip2 *bzip2 = (BZip2 *) object;
+    return bzip2->size;
+}
+size_t seq_max_length(Arguments *config, AnySystem system, AnyObject object) {
+    return config->size;
+}
+size_t psql_max_length(Arguments *config, AnySystem system, AnyObject object) {
+    Players *players = (Players *) object;
+    return players->size;
+}
+size_t mmap_max_length(Arguments *config, AnySystem system, AnyObject object) {
+    MMap *mmap = (MMap *) object;
+    return mmap->size;
+}
+size_t col_max_length(Arguments *config, AnySystem system, AnyObject object) {
+    return config->size;
+}
+
+// EXECUTION
+// Fibonacci
+void fib_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
+    uint64_t *data = (uint64_t *) object;    
+    uint64_t sum = 0;
+    SequenceBatch batch;
+    while (next(config, sequence, &batch) > 0) {
+        for (size_t i = 0; i < batch.length; i++) {
+            uint64_t start_time = Histogram_tick(latencies) ? current_time_in_ns() : 0;
+            if (batch.access[i] == ACCESS_READ) {
+                sum += data[batch.current[i]];
+            } else if (batch.access[i] == ACCESS_WRITE) {
+                data[batch.current[i]] = random_int(1000);
+            } else {
+                sum += data[batch.current[i]];
+                data[batch.current[i]] += 1;
+            }
+            if (start_time != 0) {
+                Histogram_record(latencies, current_time_in_ns() - start_time);
+            }
+        }
+    }
+    *oubliette = sum;
+}
+
+// BZip2
+void bzip_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
+    BZip2 *bzip = (BZip2 *) object;    
+    uint64_t sum = 0;
+    SequenceBatch batch;
+    while (next(config, sequence, &batch) > 0) {
+        for (size_t i = 0; i < batch.length; i++) {
+            uint64_t start_time = Histogram_tick(latencies) ? current_time_in_ns() : 0;
+            if (batch.access[i] == ACCESS_READ) {
+                sum += bzip->data[batch.current[i]];
+            } else if (batch.access[i] == ACCESS_WRITE) {
+                bzip->data[batch.current[i]] = random_int(126 - 32) + 32;
+            } else {
+                sum += bzip->data[batch.current[i]];
+                bzip->data[batch.current[i]] += 1;
+            }
+            if (start_time != 0) {
+                Histogram_record(latencies, current_time_in_ns() - start_time);
+            }
+        }
+    }
+    *oubliette = sum;
+}
+
+// Seq
+void seq_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
+    int64_t *data = (int64_t *) object;    
+    int64_t sum = 0;
+    SequenceBatch batch;
+    while (next(config, sequence, &batch) > 0) {
+        for (size_t i = 0; i < batch.length; i++) {
+            uint64_t start_time = Histogram_tick(latencies) ? current_time_in_ns() : 0;
+            if (batch.access[i] == ACCESS_READ) {
+                sum += data[batch.current[i]];
+            } else if (batch.access[i] == ACCESS_WRITE) {
+                data[batch.current[i]] = random_int(1000);
+            } else {
+                sum += data[batch.current[i]];
+                data[batch.current[i]] += 1;
+            }
+            if (start_time != 0) {
+                Histogram_record(latencies, current_time_in_ns() - start_time);
+            }
+        }
+    }
+    *oubliette = sum;
+}
+
+// PSQL
+void psql_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
+    Players *players = (Players *) object;    
+    int64_t tds = 0;
+    int64_t mvp = 0;
+    SequenceBatch batch;
+    while (next(config, sequence, &batch) > 0) {
+        for (size_t i = 0; i < batch.length; i++) {
+            uint64_t start_time = Histogram_tick(latencies) ? current_time_in_ns() : 0;
+            if (batch.access[i] == ACCESS_READ) {
+                tds += players->data[batch.current[i]].tds;
+                mvp += players->data[batch.current[i]].mvp;
+            } else if (batch.access[i] == ACCESS_WRITE) {
+                players->data[batch.current[i]].tds = random_int(100);
+                players->data[batch.current[i]].mvp = random_int(100);
+            } else {
+                tds += players->data[batch.current[i]].tds;
+                mvp += players->data[batch.current[i]].mvp;
+                players->data[batch.current[i]].tds += 1;
+                players->data[batch.current[i]].mvp += 1;
+            }
+            if (start_time != 0) {
+                Histogram_record(latencies, current_time_in_ns() - start_time);
+            }
+        }
+    }
+    *oubliette = tds + mvp;
+}
+
+// MMap
+void mmap_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
+    MMap *bzip = (MMap *) object;    
+    uint64_t sum = 0;
+    SequenceBatch batch;
+    while (next(config, sequence, &batch) > 0) {
+        for (size_t i = 0; i < batch.length; i++) {
+            uint64_t start_time = Histogram_tick(latencies) ? current_time_in_ns() : 0;
+            if (batch.access[i] == ACCESS_READ) {
+                sum += bzip->data[batch.current[i]];
+            } else if (batch.access[i] == ACCESS_WRITE) {
+                bzip->data[batch.current[i]] = random_int(126 - 32) + 32;
+            } else {
+                sum += bzip->data[batch.current[i]];
+                bzip->data[batch.current[i]] += 1;
+            }
+            if (start_time != 0) {
+                Histogram_record(latencies, current_time_in_ns() - start_time);
+            }
+        }
+    }
+    *oubliette = sum;
+}
+
+// Col
+void col_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
+    int32_t *data = (int32_t *) object;    
+    int64_t sum = 0;
+    SequenceBatch batch;
+    while (next(config, sequence, &batch) > 0) {
+        for (size_t i = 0; i < batch.length; i++) {
+            uint64_t start_time = Histogram_tick(latencies) ? current_time_in_ns() : 0;
+            if (batch.access[i] == ACCESS_READ) {
+                sum += data[batch.current[i]];
+            } else if (batch.access[i] == ACCESS_WRITE) {
+                data[batch.current[i]] = random_int(1000);
+            } else {
+                sum += data[batch.current[i]];
+                data[batch.current[i]] += 1;
+            }
+            if (start_time != 0) {
+                Histogram_record(latencies, current_time_in_ns() - start_time);
+            }
+        }
+    }
+    *oubliette = sum;
+}
+
+// BACKENDS
+// Object creation, cleanup, execution and length of one benchmark on one
+// implementation.
+typedef struct {
+    object_creation_t object_creation;
+    object_cleanup_t object_cleanup;
+    execution_t execution;
+    max_length_t max_length;
+} Backend;
+
+// Returns false if the implementation does not support the benchmark.
+bool Backend_select(char *benchmark, char *implementation, Backend *backend) {
+    memset(backend, 0, sizeof(Backend));
+    if ((strcmp(benchmark, "fib") == 0) && (strcmp(implementation, "ufo") == 0)) {
+        backend->object_creation = ufo_fib_creation;
+        backend->object_cleanup = ufo_fib_cleanup;
+        backend->execution = fib_execution;
+        backend->max_length = fib_max_length;
+    }
+    if ((strcmp(benchmark, "fib") == 0) && (strcmp(implementation, "nyc") == 0)) {
+        backend->object_creation = ny_fib_creation;
+        backend->object_cleanup = ny_fib_cleanup;
+        backend->execution = ny_fib_execution;
+        backend->max_length = ny_max_length;
+    }
+    if ((strcmp(benchmark, "fib") == 0) && (strcmp(implementation, "toronto") == 0)) {
+        backend->object_creation = toronto_fib_creation;
+        backend->object_cleanup = toronto_fib_cleanup;
+        backend->execution = toronto_fib_execution;
+        backend->max_length = toronto_max_length;
+    }
+    if ((strcmp(benchmark, "fib") == 0) && (strcmp(implementation, "nyc++") == 0)) {
+        backend->object_creation = nycpp_fib_creation;
+        backend->object_cleanup = nycpp_fib_cleanup;
+        backend->execution = nycpp_fib_execution;
+        backend->max_length = fib_max_length;
+    }
+    if ((strcmp(benchmark, "fib") == 0) && (strcmp(implementation, "normil") == 0)) {
+        backend->object_creation = normil_fib_creation;
+        backend->object_cleanup = normil_fib_cleanup;
+        backend->execution = fib_execution;
+        backend->max_length = fib_max_length;
+    }
+    if ((strcmp(benchmark, "fib") == 0) && (strcmp(implementation, "mmapfile") == 0)) {
+        backend->object_creation = mmapfile_fib_creation;
+        backend->object_cleanup = mmapfile_fib_cleanup;
+        backend->execution = fib_execution;
+        backend->max_length = fib_max_length;
+    }
+    if ((strcmp(benchmark, "mmap") == 0) && (strcmp(implementation, "ufo") == 0)) {
+        backend->object_creation = ufo_mmap_creation;
+        backend->object_cleanup = ufo_mmap_cleanup;
+        backend->execution = mmap_execution;
+        backend->max_length = mmap_max_length;
+    }
+    if ((strcmp(benchmark, "mmap") == 0) && (strcmp(implementation, "nyc") == 0)) {
+        backend->object_creation = ny_mmap_creation;
+        backend->object_cleanup = ny_mmap_cleanup;
+        backend->execution = ny_mmap_execution;
+        backend->max_length = ny_max_length;
+    }
+    if ((strcmp(benchmark, "mmap") == 0) && (strcmp(implementation, "toronto") == 0)) {
+        backend->object_creation = toronto_mmap_creation;
+        backend->object_cleanup = toronto_mmap_cleanup;
+        backend->execution = toronto_mmap_execution;
+        backend->max_length = toronto_max_length;
+    }
+    if ((strcmp(benchmark, "mmap") == 0) && (strcmp(implementation, "nyc++") == 0)) {
+        backend->object_creation = nycpp_mmap_creation;
+        backend->object_cleanup = nycpp_mmap_cleanup;
+        backend->execution = nycpp_mmap_execution;
+        backend->max_length = mmap_max_length;
+    }
+    if ((strcmp(benchmark, "mmap") == 0) && (strcmp(implementation, "normil") == 0)) {
+        backend->object_creation = normil_mmap_creation;
+        backend->object_cleanup = normil_mmap_cleanup;
+        backend->execution = mmap_execution;
+        backend->max_length = mmap_max_length;
+    }
+    if ((strcmp(benchmark, "mmap") == 0) && (strcmp(implementation, "mmapfile") == 0)) {
+        backend->object_creation = mmapfile_mmap_creation;
+        backend->object_cleanup = mmapfile_mmap_cleanup;
+        backend->execution = mmap_execution;
+        backend->max_length = mmap_max_length;
+    }
+    if ((strcmp(benchmark, "bzip") == 0) && (strcmp(implementation, "ufo") == 0)) {
+        backend->object_creation = ufo_bzip_creation;
+        backend->object_cleanup = ufo_bzip_cleanup;
+        backend->execution = bzip_execution;
+        backend->max_length = bzip_max_length;
+    }
+    if ((strcmp(benchmark, "bzip") == 0) && (strcmp(implementation, "nyc") == 0)) {
+        backend->object_creation = ny_bzip_creation;
+        backend->object_cleanup = ny_bzip_cleanup;
+        backend->execution = ny_bzip_execution;
+        backend->max_length = ny_max_length;
+    }
+    if ((strcmp(benchmark, "bzip") == 0) && (strcmp(implementation, "toronto") == 0)) {
+        backend->object_creation = toronto_bzip_creation;
+        backend->object_cleanup = toronto_bzip_cleanup;
+        backend->execution = toronto_bzip_execution;
+        backend->max_length = toronto_max_length;
+    }
+    if ((strcmp(benchmark, "bzip") == 0) && (strcmp(implementation, "nyc++") == 0)) {
+        backend->object_creation = nycpp_bzip_creation;
+        backend->object_cleanup = nycpp_bzip_cleanup;
+        backend->execution = nycpp_bzip_execution;
+        backend->max_length = bzip_max_length;
+    }
+    if ((strcmp(benchmark, "bzip") == 0) && (strcmp(implementation, "normil") == 0)) {
+        backend->object_creation = normil_bzip_creation;
+        backend->object_cleanup = normil_bzip_cleanup;
+        backend->execution = bzip_execution;
+        backend->max_length = bzip_max_length;
+    }
+    if ((strcmp(benchmark, "bzip") == 0) && (strcmp(implementation, "mmapfile") == 0)) {
+        backend->object_creation = mmapfile_bzip_creation;
+        backend->object_cleanup = mmapfile_bzip_cleanup;
+        backend->execution = bzip_execution;
+        backend->max_length = bzip_max_length;
+    }
+    if ((strcmp(benchmark, "seq") == 0) && (strcmp(implementation, "ufo") == 0)) {
+        backend->object_creation = ufo_seq_creation;
+        backend->object_cleanup = ufo_seq_cleanup;
+        backend->execution = seq_execution;
+        backend->max_length = seq_max_length;
+    }
+    if ((strcmp(benchmark, "seq") == 0) && (strcmp(implementation, "nyc") == 0)) {
+        backend->object_creation = ny_seq_creation;
+        backend->object_cleanup = ny_seq_cleanup;
+        backend->execution = ny_seq_execution;
+        backend->max_length = ny_max_length;
+    }
+    if ((strcmp(benchmark, "seq") == 0) && (strcmp(implementation, "toronto") == 0)) {
+        backend->object_creation = toronto_seq_creation;
+        backend->object_cleanup = toronto_seq_cleanup;
+        backend->execution = toronto_seq_execution;
+        backend->max_length = toronto_max_length;
+    }
+    if ((strcmp(benchmark, "seq") == 0) && (strcmp(implementation, "nyc++") == 0)) {
+        backend->object_creation = nycpp_seq_creation;
+        backend->object_cleanup = nycpp_seq_cleanup;
+        backend->execution = nycpp_seq_execution;
+        backend->max_length = seq_max_length;
+    }
+    if ((strcmp(benchmark, "seq") == 0) && (strcmp(implementation, "normil") == 0)) {
+        backend->object_creation = normil_seq_creation;
+        backend->object_cleanup = normil_seq_cleanup;
+        backend->execution = seq_execution;
+        backend->max_length = seq_max_length;
+    }
+    if ((strcmp(benchmark, "seq") == 0) && (strcmp(implementation, "mmapfile") == 0)) {
+        backend->object_creation = mmapfile_seq_creation;
+        backend->object_cleanup = mmapfile_seq_cleanup;
+        backend->execution = seq_execution;
+        backend->max_length = seq_max_length;
+    }
+    if ((strcmp(benchmark, "tseq") == 0) && (strcmp(implementation, "ufo") == 0)) {
+        backend->object_creation = ufo_tseq_creation;
+        backend->object_cleanup = ufo_tseq_cleanup;
+        backend->execution = tseq_execution;
+        backend->max_length = seq_max_length;
+    }
+    if ((strcmp(benchmark, "tseq") == 0) && (strcmp(implementation, "nyc") == 0)) {
+        backend->object_creation = ny_tseq_creation;
+        backend->object_cleanup = ny_tseq_cleanup;
+        backend->execution = ny_tseq_execution;
+        backend->max_length = ny_max_length;
+    }
+    if ((strcmp(benchmark, "tseq") == 0) && (strcmp(implementation, "toronto") == 0)) {
+        backend->object_creation = toronto_tseq_creation;
+        backend->object_cleanup = toronto_tseq_cleanup;
+        backend->execution = toronto_tseq_execution;
+        backend->max_length = toronto_max_length;
+    }
+    if ((strcmp(benchmark, "tseq") == 0) && (strcmp(implementation, "normil") == 0)) {
+        backend->object_creation = normil_tseq_creation;
+        backend->object_cleanup = normil_tseq_cleanup;
+        backend->execution = tseq_execution;
+        backend->max_length = seq_max_length;
+    }
+    if ((strcmp(benchmark, "rep") == 0) && (strcmp(implementation, "ufo") == 0)) {
+        backend->object_creation = ufo_rep_creation;
+        backend->object_cleanup = ufo_rep_cleanup;
+        backend->execution = seq_execution;
+        backend->max_length = seq_max_length;
+    }
+    if ((strcmp(benchmark, "rep") == 0) && (strcmp(implementation, "nyc") == 0)) {
+        backend->object_creation = ny_rep_creation;
+        backend->object_cleanup = ny_rep_cleanup;
+        backend->execution = ny_seq_execution;
+        backend->max_length = ny_max_length;
+    }
+    if ((strcmp(benchmark, "rep") == 0) && (strcmp(implementation, "toronto") == 0)) {
+        backend->object_creation = toronto_rep_creation;
+        backend->object_cleanup = toronto_rep_cleanup;
+        backend->execution = toronto_seq_execution;
+        backend->max_length = toronto_max_length;
+    }
+    if ((strcmp(benchmark, "rep") == 0) && (strcmp(implementation, "normil") == 0)) {
+        backend->object_creation = normil_rep_creation;
+        backend->object_cleanup = normil_rep_cleanup;
+        backend->execution = seq_execution;
+        backend->max_length = seq_max_length;
+    }
+    if ((strcmp(benchmark, "rep-each") == 0) && (strcmp(implementation, "ufo") == 0)) {
+        backend->object_creation = ufo_rep_each_creation;
+        backend->object_cleanup = ufo_rep_cleanup;
+        backend->execution = seq_execution;
+        backend->max_length = seq_max_length;
+    }
+    if ((strcmp(benchmark, "rep-each") == 0) && (strcmp(implementation, "nyc") == 0)) {
+        backend->object_creation = ny_rep_each_creation;
+        backend->object_cleanup = ny_rep_cleanup;
+        backend->execution = ny_seq_execution;
+        backend->max_length = ny_max_length;
+    }
+    if ((strcmp(benchmark, "rep-each") == 0) && (strcmp(implementation, "toronto") == 0)) {
+        backend->object_creation = toronto_rep_each_creation;
+        backend->object_cleanup = toronto_rep_cleanup;
+        backend->execution = toronto_seq_execution;
+        backend->max_length = toronto_max_length;
+    }
+    if ((strcmp(benchmark, "rep-each") == 0) && (strcmp(implementation, "normil") == 0)) {
+        backend->object_creation = normil_rep_each_creation;
+        backend->object_cleanup = normil_rep_cleanup;
+        backend->execution = seq_execution;
+        backend->max_length = seq_max_length;
+    }
+    if ((strcmp(benchmark, "rep-len") == 0) && (strcmp(implementation, "ufo") == 0)) {
+        backend->object_creation = ufo_rep_len_creation;
+        backend->object_cleanup = ufo_rep_cleanup;
+        backend->execution = seq_execution;
+        backend->max_length = seq_max_length;
+    }
+    if ((strcmp(benchmark, "rep-len") == 0) && (strcmp(implementation, "nyc") == 0)) {
+        backend->object_creation = ny_rep_len_creation;
+        backend->object_cleanup = ny_rep_cleanup;
+        backend->execution = ny_seq_execution;
+        backend->max_length = ny_max_length;
+    }
+    if ((strcmp(benchmark, "rep-len") == 0) && (strcmp(implementation, "toronto") == 0)) {
+        backend->object_creation = toronto_rep_len_creation;
+        backend->object_cleanup = toronto_rep_cleanup;
+        backend->execution = toronto_seq_execution;
+        backend->max_length = toronto_max_length;
+    }
+    if ((strcmp(benchmark, "rep-len") == 0) && (strcmp(implementation, "normil") == 0)) {
+        backend->object_creation = normil_rep_len_creation;
+        backend->object_cleanup = normil_rep_cleanup;
+        backend->execution = seq_execution;
+        backend->max_length = seq_max_length;
+    }
+    if ((strcmp(benchmark, "outer") == 0) && (strcmp(implementation, "ufo") == 0)) {
+        backend->object_creation = ufo_outer_creation;
+        backend->object_cleanup = ufo_rep_cleanup;
+        backend->execution = seq_execution;
+        backend->max_length = seq_max_length;
+    }
+    if ((strcmp(benchmark, "outer") == 0) && (strcmp(implementation, "nyc") == 0)) {
+        backend->object_creation = ny_outer_creation;
+        backend->object_cleanup = ny_rep_cleanup;
+        backend->execution = ny_seq_execution;
+        backend->max_length = ny_max_length;
+    }
+    if ((strcmp(benchmark, "outer") == 0) && (strcmp(implementation, "toronto") == 0)) {
+        backend->object_creation = toronto_outer_creation;
+        backend->object_cleanup = toronto_rep_cleanup;
+        backend->execution = toronto_seq_execution;
+        backend->max_length = toronto_max_length;
+    }
+    if ((strcmp(benchmark, "outer") == 0) && (strcmp(implementation, "normil") == 0)) {
+        backend->object_creation = normil_outer_creation;
+        backend->object_cleanup = normil_rep_cleanup;
+        backend->execution = seq_execution;
+        backend->max_length = seq_max_length;
+    }
+    if ((strcmp(benchmark, "psql") == 0) && (strcmp(implementation, "ufo") == 0)) {
+        backend->object_creation = ufo_psql_creation;
+        backend->object_cleanup = ufo_psql_cleanup;
+        backend->execution = psql_execution;
+        backend->max_length = psql_max_length;
+    }
+    if ((strcmp(benchmark, "psql") == 0) && (strcmp(implementation, "nyc") == 0)) {
+        backend->object_creation = ny_psql_creation;
+        backend->object_cleanup = ny_psql_cleanup;
+        backend->execution = ny_psql_execution;
+        backend->max_length = ny_max_length;
+    }
+    if ((strcmp(benchmark, "psql") == 0) && (strcmp(implementation, "toronto") == 0)) {
+        backend->object_creation = toronto_psql_creation;
+        backend->object_cleanup = toronto_psql_cleanup;
+        backend->execution = toronto_psql_execution;
+        backend->max_length = toronto_max_length;
+    }
+    if ((strcmp(benchmark, "psql") == 0) && (strcmp(implementation, "nyc++") == 0)) {
+        backend->object_creation = nycpp_psql_creation;
+        backend->object_cleanup = nycpp_psql_cleanup;
+        backend->execution = nycpp_psql_execution;
+        backend->max_length = psql_max_length;
+    }
+    if ((strcmp(benchmark, "psql") == 0) && (strcmp(implementation, "normil") == 0)) {
+        backend->object_creation = normil_psql_creation;
+        backend->object_cleanup = normil_psql_cleanup;
+        backend->execution = psql_execution;
+        backend->max_length = psql_max_length;
+    }
+    if ((strcmp(benchmark, "psql") == 0) && (strcmp(implementation, "mmapfile") == 0)) {
+        backend->object_creation = mmapfile_psql_creation;
+        backend->object_cleanup = mmapfile_psql_cleanup;
+        backend->execution = psql_execution;
+        backend->max_length = psql_max_length;
+    }
+    if ((strcmp(benchmark, "col") == 0) && (strcmp(implementation, "ufo") == 0)) {
+        backend->object_creation = ufo_col_creation;
+        backend->object_cleanup = ufo_col_cleanup;
+        backend->execution = col_execution;
+        backend->max_length = col_max_length;
+    }
+    if ((strcmp(benchmark, "col") == 0) && (strcmp(implementation, "nyc") == 0)) {
+        backend->object_creation = ny_col_creation;
+        backend->object_cleanup = ny_col_cleanup;
+        backend->execution = ny_col_execution;
+        backend->max_length = ny_max_length;
+    }
+    if ((strcmp(benchmark, "col") == 0) && (strcmp(implementation, "toronto") == 0)) {
+        backend->object_creation = toronto_col_creation;
+        backend->object_cleanup = toronto_col_cleanup;
+        backend->execution = toronto_col_execution;
+        backend->max_length = toronto_max_length;
+    }
+    if ((strcmp(benchmark, "col") == 0) && (strcmp(implementation, "nyc++") == 0)) {
+        backend->object_creation = nycpp_col_creation;
+        backend->object_cleanup = nycpp_col_cleanup;
+        backend->execution = nycpp_col_execution;
+        backend->max_length = col_max_length;
+    }
+    if ((strcmp(benchmark, "col") == 0) && (strcmp(implementation, "normil") == 0)) {
+        backend->object_creation = normil_col_creation;
+        backend->object_cleanup = normil_col_cleanup;
+        backend->execution = col_execution;
+        backend->max_length = col_max_length;
+    }
+    if ((strcmp(benchmark, "col") == 0) && (strcmp(implementation, "mmapfile") == 0)) {
+        backend->object_creation = mmapfile_col_creation;
+        backend->object_cleanup = mmapfile_col_cleanup;
+        backend->execution = col_execution;
+        backend->max_length = col_max_length;
+    }
+    return backend->object_creation != NULL && backend->object_cleanup != NULL;
+}
+
+// MIXED OBJECTS
+// The mix benchmark creates one object for each benchmark listed in
+// --objects, all in the same system, and interleaves accesses to them. Each
+// turn picks an object at random, in proportion to its weight, and runs the
+// next --quantum accesses of that object's own index sequence.
+typedef struct {
+    char *benchmark;
+    size_t weight;
+    Backend backend;
+    AnyObject object;
+    PopulateCounters populate;   // All populate calls of the object, counted by the wrapper.
+} MixObject;
+
+typedef struct {
+    char *list;   // Backing storage of the benchmark names.
+    size_t count;
+    MixObject *objects;
+} Mix;
+
+// What one object of the mix did during one execution.
+typedef struct {
+    char *benchmark;
+    size_t weight;
+    size_t accesses;
+    size_t turns;
+    uint64_t time;       // Nanoseconds spent in this object's turns.
+    double throughput;   // Accesses per second of this object's turns.
+    PopulateCounters populate;
+    size_t dirty_chunks;
+} MixResult;
+
+void Mix_free(Mix *mix) {
+    free(mix->objects);
+    free(mix->list);
+    mix->objects = NULL;
+    mix->list = NULL;
+    mix->count = 0;
+}
+
+// Parses a list of benchmark:weight pairs, where the weight defaults to 1.
+// Returns non-zero if the list is invalid, and then leaves nothing allocated.
+int Mix_parse(Mix *mix, char *list, char *implementation) {
+    char **items;
+    mix->list = strdup(list);
+    mix->count = split_list(mix->list, &items);
+    mix->objects = NULL;
+    if (mix->count == 0) {
+        REPORT("Object list must not be empty\n");
+        free(items);
+        Mix_free(mix);
+        return 6;
+    }
+    mix->objects = (MixObject *) calloc(mix->count, sizeof(MixObject));
+    int status = 0;
+    for (size_t i = 0; i < mix->count && status == 0; i++) {
+        MixObject *object = &mix->objects[i];
+        char *weight = strchr(items[i], ':');
+        if (weight != NULL) {
+            *weight = '\0';
+            weight++;
+        }
+        object->benchmark = items[i];
+        object->weight = weight == NULL ? 1 : (size_t) atol(weight);
+        if (object->weight == 0) {
+            REPORT("Weight of object \"%s\" must be at least 1\n", object->benchmark);
+            status = 6;
+        } else if (!Backend_select(object->benchmark, implementation, &object->backend)) {
+            REPORT("Unknown benchmark/implementation combination \"%s\"/\"%s\"\n", 
+                object->benchmark, implementation);
+            status = 4;
+        }
+    }
+    free(items);
+    if (status != 0) {
+        Mix_free(mix);
+    }
+    return status;
+}
+
+// Populate calls are attributed to the object that was being created when
+// its populate function was wrapped.
+void Mix_create(Mix *mix, Arguments *config, AnySystem system) {
+    for (size_t i = 0; i < mix->count; i++) {
+        MixObject *object = &mix->objects[i];
+        instrument_scope(&object->populate);
+        object->object = object->backend.object_creation(config, system);
+        instrument_scope(NULL);
+    }
+}
+
+void Mix_cleanup(Mix *mix, Arguments *config, AnySystem system) {
+    for (size_t i = 0; i < mix->count; i++) {
+        MixObject *object = &mix->objects[i];
+        object->backend.object_cleanup(config, system, object->object);
+        object->object = NULL;
+    }
+}
+
+// Index sequence of one object of the mix. An object may get more accesses
+// than it has elements, so the pattern starts over whenever it runs out.
+typedef struct {
+    AnySequence sequence;
+    sequence_t next;
+    size_t remaining;
+    size_t max_length;
+    DirtyTracker *dirty;
+} MixSequence;
+
+size_t MixSequence_next(Arguments *config, AnySequence sequence, SequenceBatch *batch) {
+    MixSequence *mix_sequence = (MixSequence *) sequence;
+    while (mix_sequence->remaining > 0) {
+        if (mix_sequence->sequence == NULL) {
+            size_t length = mix_sequence->remaining < mix_sequence->max_length 
+                ? mix_sequence->remaining : mix_sequence->max_length;
+            mix_sequence->sequence = sequence_new(config, 0, length, mix_sequence->max_length, 
+                                                  mix_sequence->dirty, &mix_sequence->next);
+        }
+        size_t length = mix_sequence->next(config, mix_sequence->sequence, batch);
+        if (length > 0) {
+            if (length > mix_sequence->remaining) {
+                length = mix_sequence->remaining;
+                batch->length = length;
+            }
+            mix_sequence->remaining -= length;
+            if (mix_sequence->remaining == 0) {
+                free(mix_sequence->sequence);
+                mix_sequence->sequence = NULL;
+            }
+            return length;
+        }
+        free(mix_sequence->sequence);
+        mix_sequence->sequence = NULL;
+    }
+    return 0;
+}
+
+void MixSequence_free(MixSequence *mix_sequence) {
+    free(mix_sequence->sequence);
+    free(mix_sequence);
+}
+
+// One turn: a slice of the batch the object's sequence generated last.
+typedef struct {
+    SequenceBatch *source;
+    size_t position;
+    size_t length;
+} MixTurn;
+
+size_t MixTurn_next(Arguments *config, AnySequence sequence, SequenceBatch *batch) {
+    MixTurn *turn = (MixTurn *) sequence;
+    size_t length = turn->length;
+    memcpy(batch->current, turn->source->current + turn->position, length * sizeof(size_t));
+    memcpy(batch->access, turn->source->access + turn->position, length * sizeof(uint8_t));
+    turn->length = 0;
+    batch->length = length;
+    return length;
+}
+
+// ADDRESS LOOKUP
+// Latencies measured by the lookup benchmark once the population of live
+// objects reached a given size.
+typedef struct {
+    size_t population;
+    size_t failures;
+    Histogram creation_latencies;   // Objects created to grow to this population.
+    Histogram lookup_latencies;     // Lookups of an object's first element.
+    Histogram interior_latencies;   // Lookups of a random element inside an object.
+    Histogram cleanup_latencies;
+} LookupResult;
+
+// PHASES
+typedef enum {
+    SYSTEM_SETUP,
+    OBJECT_CREATION,
+    EXECUTION,
+    OBJECT_CLEANUP,
+    SYSTEM_TEARDOWN,
+    PHASES,
+} Phase;
+
+const char *phase_names[PHASES] = {
+    "system_setup",
+    "object_creation",
+    "execution",
+    "object_cleanup",
+    "system_teardown",
+};
+
+// Everything measured in one repetition of the benchmark. Phases that do
+// not run in every repetition (system setup and teardown, and object
+// creation and cleanup when the object is reused) are only recorded in the
+// repetition in which they ran.
+typedef struct {
+    Arguments config;
+    size_t repetition;
+    bool ran[PHASES];
+    uint64_t start_time;
+    uint64_t elapsed_time[PHASES];
+    MemoryStats memory_before[PHASES];
+    MemoryStats memory_after[PHASES];
+    PerfReading perf_before[PHASES];
+    PerfReading perf_after[PHASES];
+    PopulateCounters populate_before[PHASES];
+    PopulateCounters populate_after[PHASES];
+    PopulateThread *populate_threads;   // Per-thread populate counters during execution.
+    size_t populate_threads_count;
+    MemorySampler memory_sampler;
+    Histogram latencies;
+    size_t sequence_length;
+    double throughput;
+    uint64_t *thread_execution_times;
+    MixResult *mix_results;   // One per object of the mix benchmark.
+    size_t mix_results_count;
+    Histogram creation_latencies;   // Churn benchmark only.
+    Histogram cleanup_latencies;
+    size_t objects_churned;
+    LookupResult *lookup_results;   // Lookup benchmark only, one per population.
+    size_t lookup_results_count;
+    int64_t oubliette;
+    size_t write_accesses;
+    size_t dirty_chunks;
+    uint64_t read_only_time;   // Same sequence with writes turned off, zero if not measured.
+    size_t file_cached;        // Bytes of the input file in the page cache before object creation.
+    bool caches_dropped;
+    bool constrained;          // Execution ran in a cgroup with memory.max.
+    bool creation_constrained; // So did object creation, not done for reused objects.
+    CgroupStats cgroup;
+} Run;
+
+// Memory and perf counters are read just outside of the timed region.
+void Run_begin(Run *run, PerfCounters *perf, Phase phase) {
+    instrument_totals(&run->populate_before[phase]);
+    MemoryStats_now(&run->memory_before[phase]);
+    PerfCounters_read(perf, &run->perf_before[phase]);
+    run->start_time = current_time_in_ns();
+}
+
+void Run_end(Run *run, PerfCounters *perf, Phase phase) {
+    run->elapsed_time[phase] = current_time_in_ns() - run->start_time;
+    PerfCounters_read(perf, &run->perf_after[phase]);
+    MemoryStats_now(&run->memory_after[phase]);
+    instrument_totals(&run->populate_after[phase]);
+    run->ran[phase] = true;
+    if (trace_enabled()) {
+        trace_phase(phase_names[phase], run->repetition, run->start_time, run->start_time + run->elapsed_time[phase]);
+    }
+}
+
+// The repetition which holds the measurements of the given phase for
+// repetition `index`: either that repetition itself, or the one in which a
+// shared phase ran.
+Run *Run_of_phase(Run *runs, size_t count, size_t index, Phase phase) {
+    if (runs[index].ran[phase]) {
+        return &runs[index];
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (runs[i].ran[phase]) {
+            return &runs[i];
+        }
+    }
+    return &runs[index];
+}
+
+// Populate counters accumulated during a phase.
+void Run_populate(Run *run, Phase phase, PopulateCounters *delta) {
+    delta->calls = run->populate_after[phase].calls - run->populate_before[phase].calls;
+    delta->bytes = run->populate_after[phase].bytes - run->populate_before[phase].bytes;
+    delta->time = run->populate_after[phase].time - run->populate_before[phase].time;
+}
+
+// How much longer the execution took than a read-only execution of the same
+// index sequence, as a fraction. Zero if there was no read-only baseline.
+double Run_writeback_slowdown(Run *run) {
+    if (run->read_only_time == 0) {
+        return 0;
+    }
+    return ((double) run->elapsed_time[EXECUTION]) / ((double) run->read_only_time) - 1.0;
+}
+
+// Puts the input file into the requested page cache state right before an
+// object is created, and records how much of it was cached then.
+void Run_prepare_cache(Run *run, Arguments *config) {
+    static bool warned = false;
+    if (strcmp(config->cache_state, "cold") == 0) {
+        if (!page_cache_evict(config->file, true, &run->caches_dropped)) {
+            WARN("Cannot open \"%s\" to evict it from the page cache\n", config->file);
+        } else if (!run->caches_dropped && !warned) {
+            WARN("Cannot drop caches without root, only evicting \"%s\"\n", config->file);
+            warned = true;
+        }
+    }
+    if (strcmp(config->cache_state, "warm") == 0 && !page_cache_warm(config->file)) {
+        WARN("Cannot read \"%s\" into the page cache\n", config->file);
+    }
+    run->file_cached = page_cache_resident(config->file);
+}
+
+// Leaves the repetition's cgroup, if it entered one, and records what the
+// cgroup saw before removing it.
+void Run_constrained(Run *run, Cgroup *cgroup) {
+    if (run->constrained) {
+        Cgroup_leave(cgroup);
+        Cgroup_read(cgroup, &run->cgroup);
+    }
+    if (cgroup->active) {
+        Cgroup_destroy(cgroup);
+    }
+}
+
+// Runs the execution phase with config->threads workers. Returns non-zero if
+// the index sequence cannot be created.
+int Run_execute(Run *run, PerfCounters *perf, Arguments *config, AnySystem system, AnyObject object, 
+                execution_t execution, max_length_t max_length) {
+
+    INFO("Index sequence configuration\n");
+    size_t max_sequence_length = max_length(config, system, object);
+    run->sequence_length = 
+        (config->sample_size != 0 && max_sequence_length > config->sample_size) 
+        ? config->sample_size : max_sequence_length;
+
+    DirtyTracker dirty;
+    DirtyTracker_init(&dirty, config->min_load, max_sequence_length);
+
+    // Each worker gets its own iterator over a contiguous slice of the
+    // sequence, and its own partial oubliette.
+    Worker *workers = (Worker *) calloc(config->threads, sizeof(Worker));
+    for (size_t t = 0; t < config->threads; t++) {
+        size_t slice_start = run->sequence_length * t / config->threads;
+        size_t slice_end = run->sequence_length * (t + 1) / config->threads;
+        workers[t].index = t;
+        workers[t].config = config;
+        workers[t].system = system;
+        workers[t].perf = perf;
+        workers[t].object = object;
+        workers[t].execution = execution;
+        workers[t].length = slice_end - slice_start;
+        Histogram_init(&workers[t].latencies, config->latency_sample);
+        random_seed(config->seed + t);
+        workers[t].sequence = sequence_new(config, slice_start, workers[t].length, max_sequence_length, &dirty, &workers[t].next);
+        if (workers[t].sequence == NULL) {
+            INFO("Unknown sequence pattern \"%s\"\n", config->pattern);
+            return 5;
+        }
+        if (config->pregenerate) {
+            workers[t].sequence = sequence_pregenerate(config, workers[t].sequence, workers[t].next, 
+                                                       workers[t].length, &workers[t].next);
+        }
+    }
+
+    INFO("Execution\n");
+    PopulateThread *populate_threads_before = (PopulateThread *) calloc(INSTRUMENT_MAX_THREADS + 1, sizeof(PopulateThread));
+    size_t populate_threads_before_count = instrument_threads(populate_threads_before, INSTRUMENT_MAX_THREADS + 1);
+    size_t populate_overflowed_before = instrument_overflowed();
+    Run_begin(run, perf, EXECUTION);
+    MemorySampler_start(&run->memory_sampler, config->memory_sample_interval * 1000000);
+    if (config->threads == 1) {
+        Worker_run(&workers[0]);
+    } else {
+        pthread_t *threads = (pthread_t *) malloc(sizeof(pthread_t) * config->threads);
+        pthread_barrier_t barrier;
+        pthread_barrier_init(&barrier, NULL, config->threads + 1);
+        for (size_t t = 0; t < config->threads; t++) {
+            workers[t].barrier = &barrier;
+            if (0 != pthread_create(&threads[t], NULL, Worker_run, &workers[t])) {
+                REPORT("Cannot start worker thread %lu\n", t);
+                exit(6);
+            }
+        }
+        pthread_barrier_wait(&barrier);
+        for (size_t t = 0; t < config->threads; t++) {
+            pthread_join(threads[t], NULL);
+        }
+        pthread_barrier_destroy(&barrier);
+        free(threads);
+    }
+    MemorySampler_stop(&run->memory_sampler);
+    Run_end(run, perf, EXECUTION);
+
+    // Only keep the threads that populated something during execution. Rows
+    // come in slot order with the overflow slot last; a slot that passed to
+    // another thread in between has a new generation and counts from zero.
+    run->populate_threads = (PopulateThread *) calloc(INSTRUMENT_MAX_THREADS + 1, sizeof(PopulateThread));
+    size_t populate_threads_count = instrument_threads(run->populate_threads, INSTRUMENT_MAX_THREADS + 1);
+    run->populate_threads_count = 0;
+    for (size_t i = 0; i < populate_threads_count; i++) {
+        PopulateThread thread = run->populate_threads[i];
+        size_t before = thread.overflow ? populate_threads_before_count - 1 : i;
+        if (before < populate_threads_before_count
+            && populate_threads_before[before].overflow == thread.overflow
+            && populate_threads_before[before].generation == thread.generation) {
+            thread.counters.calls -= populate_threads_before[before].counters.calls;
+            thread.counters.bytes -= populate_threads_before[before].counters.bytes;
+            thread.counters.time -= populate_threads_before[before].counters.time;
+        }
+        if (thread.counters.calls != 0) {
+            run->populate_threads[run->populate_threads_count++] = thread;
+        }
+    }
+    free(populate_threads_before);
+    size_t populate_overflowed = instrument_overflowed() - populate_overflowed_before;
+    if (populate_overflowed != 0) {
+        WARN("%lu populating threads found all %d instrumentation slots taken and were counted in the shared overflow slot\n", 
+            populate_overflowed, INSTRUMENT_MAX_THREADS);
+    }
+
+    // Only count from the moment the first worker started to the moment the
+    // last one finished, using the workers' own clocks: on a busy machine the
+    // main thread may not get scheduled again until after the workers are
+    // done.
+    uint64_t execution_start_time = UINT64_MAX, execution_end_time = 0;
+    for (size_t t = 0; t < config->threads; t++) {
+        uint64_t end_time = workers[t].start_time + workers[t].elapsed_time;
+        if (workers[t].start_time < execution_start_time) execution_start_time = workers[t].start_time;
+        if (end_time > execution_end_time) execution_end_time = end_time;
+    }
+    uint64_t execution_elapsed_time = execution_end_time - execution_start_time;
+    run->elapsed_time[EXECUTION] = execution_elapsed_time;
+
+    Histogram_init(&run->latencies, config->latency_sample);
+    run->thread_execution_times = (uint64_t *) malloc(sizeof(uint64_t) * config->threads);
+    run->oubliette = 0;
+    for (size_t t = 0; t < config->threads; t++) {
+        run->oubliette += workers[t].oubliette;
+        run->thread_execution_times[t] = workers[t].elapsed_time;
+        Histogram_merge(&run->latencies, &workers[t].latencies);
+        free(workers[t].sequence);
+    }
+    free(workers);
+
+    run->write_accesses = dirty.writes;
+    run->dirty_chunks = DirtyTracker_count(&dirty);
+    DirtyTracker_free(&dirty);
+
+    // Accesses per second, across all threads.
+    run->throughput = execution_elapsed_time == 0 ? 0 
+        : ((double) run->sequence_length) * 1000000000.0 / ((double) execution_elapsed_time);
+    return 0;
+}
+
+// Per-object state of a mix execution.
+typedef struct {
+    DirtyTracker dirty;
+    AnySequence sequence;
+    sequence_t next;
+    SequenceBatch batch;
+    size_t position;
+    size_t remaining;
+    PopulateCounters populate_before;
+} MixState;
+
+// Runs the execution phase of the mix benchmark on one thread. Accesses are
+// split between the objects by weight; the sample size is the total, and
+// zero stands for the sum of the objects' lengths.
+int Run_execute_mix(Run *run, PerfCounters *perf, Arguments *config, AnySystem system, Mix *mix) {
+
+    INFO("Index sequence configuration\n");
+    size_t total_weight = 0;
+    size_t total_max_length = 0;
+    size_t *max_lengths = (size_t *) malloc(sizeof(size_t) * mix->count);
+    for (size_t k = 0; k < mix->count; k++) {
+        MixObject *object = &mix->objects[k];
+        max_lengths[k] = object->backend.max_length(config, system, object->object);
+        total_max_length += max_lengths[k];
+        total_weight += object->weight;
+    }
+    size_t total_length = config->sample_size != 0 ? config->sample_size : total_max_length;
+
+    MixState *states = (MixState *) calloc(mix->count, sizeof(MixState));
+    run->mix_results = (MixResult *) calloc(mix->count, sizeof(MixResult));
+    run->mix_results_count = mix->count;
+    run->sequence_length = 0;
+    size_t active_weight = 0;
+    size_t cumulative_weight = 0;
+    for (size_t k = 0; k < mix->count; k++) {
+        MixObject *object = &mix->objects[k];
+        MixState *state = &states[k];
+        size_t share_start = total_length * cumulative_weight / total_weight;
+        cumulative_weight += object->weight;
+        size_t share_end = total_length * cumulative_weight / total_weight;
+        state->remaining = max_lengths[k] == 0 ? 0 : share_end - share_start;
+        run->sequence_length += state->remaining;
+        if (state->remaining > 0) {
+            active_weight += object->weight;
+        }
+
+        DirtyTracker_init(&state->dirty, config->min_load, max_lengths[k]);
+        MixSequence *mix_sequence = (MixSequence *) calloc(1, sizeof(MixSequence));
+        mix_sequence->remaining = state->remaining;
+        mix_sequence->max_length = max_lengths[k];
+        mix_sequence->dirty = &state->dirty;
+        state->sequence = (AnySequence) mix_sequence;
+        state->next = &MixSequence_next;
+        if (config->pregenerate) {
+            state->sequence = sequence_pregenerate(config, state->sequence, state->next, state->remaining, &state->next);
+        }
+
+        run->mix_results[k].benchmark = object->benchmark;
+        run->mix_results[k].weight = object->weight;
+        state->populate_before = object->populate;
+    }
+    free(max_lengths);
+
+    INFO("Execution\n");
+    Histogram_init(&run->latencies, config->latency_sample);
+    run->oubliette = 0;
+    Run_begin(run, perf, EXECUTION);
+    MemorySampler_start(&run->memory_sampler, config->memory_sample_interval * 1000000);
+    while (active_weight > 0) {
+        size_t pick = random_index(active_weight);
+        size_t k = 0;
+        for (;; k++) {
+            if (states[k].remaining == 0) continue;
+            if (pick < mix->objects[k].weight) break;
+            pick -= mix->objects[k].weight;
+        }
+        MixObject *object = &mix->objects[k];
+        MixState *state = &states[k];
+        MixResult *result = &run->mix_results[k];
+
+        if (state->position == state->batch.length) {
+            state->position = 0;
+            if (state->next(config, state->sequence, &state->batch) == 0) {
+                state->remaining = 0;
+                active_weight -= object->weight;
+                continue;
+            }
+        }
+        MixTurn turn;
+        turn.source = &state->batch;
+        turn.position = state->position;
+        turn.length = state->batch.length - state->position;
+        if (turn.length > config->quantum) {
+            turn.length = config->quantum;
+        }
+        size_t length = turn.length;
+
+        int64_t oubliette = 0;
+        uint64_t start_time = current_time_in_ns();
+        object->backend.execution(config, system, object->object, (AnySequence) &turn, MixTurn_next, 
+                                  &run->latencies, &oubliette);
+        result->time += current_time_in_ns() - start_time;
+        run->oubliette += oubliette;
+
+        state->position += length;
+        result->accesses += length;
+        result->turns++;
+        if (length >= state->remaining) {
+            state->remaining = 0;
+            active_weight -= object->weight;
+        } else {
+            state->remaining -= length;
+        }
+    }
+    MemorySampler_stop(&run->memory_sampler);
+    Run_end(run, perf, EXECUTION);
+
+    run->write_accesses = 0;
+    run->dirty_chunks = 0;
+    for (size_t k = 0; k < mix->count; k++) {
+        MixObject *object = &mix->objects[k];
+        MixState *state = &states[k];
+        MixResult *result = &run->mix_results[k];
+        result->throughput = result->time == 0 ? 0 
+            : ((double) result->accesses) * 1000000000.0 / ((double) result->time);
+        result->populate.calls = object->populate.calls - state->populate_before.calls;
+        result->populate.bytes = object->populate.bytes - state->populate_before.bytes;
+        result->populate.time = object->populate.time - state->populate_before.time;
+        result->dirty_chunks = DirtyTracker_count(&state->dirty);
+        run->write_accesses += state->dirty.writes;
+        run->dirty_chunks += result->dirty_chunks;
+        DirtyTracker_free(&state->dirty);
+        if (config->pregenerate) {
+            free(state->sequence);
+        } else {
+            MixSequence_free((MixSequence *) state->sequence);
+        }
+    }
+    free(states);
+
+    run->thread_execution_times = (uint64_t *) malloc(sizeof(uint64_t));
+    run->thread_execution_times[0] = run->elapsed_time[EXECUTION];
+    run->throughput = run->elapsed_time[EXECUTION] == 0 ? 0 
+        : ((double) run->sequence_length) * 1000000000.0 / ((double) run->elapsed_time[EXECUTION]);
+    return 0;
+}
+
+// CHURN
+// The churn benchmark times object creation and cleanup themselves. Every
+// thread creates --churn objects of the --churn-object benchmark and frees
+// them again, keeping up to --live of them alive at once: a new object
+// replaces the oldest one, so that cleanup looks objects up among that
+// many others.
+typedef struct {
+    size_t index;
+    Arguments *config;
+    AnySystem system;
+    Backend *backend;
+    pthread_barrier_t *barrier;
+    PerfCounters *perf;
+    size_t failures;
+    uint64_t start_time;
+    uint64_t elapsed_time;
+    Histogram creation_latencies;
+    Histogram cleanup_latencies;
+} ChurnWorker;
+
+static inline void ChurnWorker_cleanup(ChurnWorker *worker, AnyObject object) {
+    uint64_t start_time = current_time_in_ns();
+    worker->backend->object_cleanup(worker->config, worker->system, object);
+    Histogram_record(&worker->cleanup_latencies, current_time_in_ns() - start_time);
+}
+
+void *ChurnWorker_run(void *argument) {
+    ChurnWorker *worker = (ChurnWorker *) argument;
+    Arguments *config = worker->config;
+    AnyObject *live = (AnyObject *) calloc(config->live, sizeof(AnyObject));
+    if (trace_enabled() && worker->barrier != NULL) {
+        char name[32];
+        snprintf(name, sizeof(name), "churn %lu", worker->index);
+        trace_thread_name(strdup(name));
+    }
+    if (worker->barrier != NULL) {
+        PerfCounters_attach(worker->perf);
+        pthread_barrier_wait(worker->barrier);
+    }
+    worker->start_time = current_time_in_ns();
+    for (size_t i = 0; i < config->churn; i++) {
+        size_t slot = i % config->live;
+        if (live[slot] != NULL) {
+            ChurnWorker_cleanup(worker, live[slot]);
+        }
+        uint64_t start_time = current_time_in_ns();
+        live[slot] = worker->backend->object_creation(config, worker->system);
+        Histogram_record(&worker->creation_latencies, current_time_in_ns() - start_time);
+        if (live[slot] == NULL) {
+            worker->failures++;
+        }
+    }
+    for (size_t slot = 0; slot < config->live; slot++) {
+        if (live[slot] != NULL) {
+            ChurnWorker_cleanup(worker, live[slot]);
+        }
+    }
+    worker->elapsed_time = current_time_in_ns() - worker->start_time;
+    free(live);
+    return NULL;
+}
+
+// Runs the churn benchmark as the execution phase, with config->threads
+// workers. Throughput is in objects per second.
+int Run_churn(Run *run, PerfCounters *perf, Arguments *config, AnySystem system, Backend *backend) {
+    ChurnWorker *workers = (ChurnWorker *) calloc(config->threads, sizeof(ChurnWorker));
+    for (size_t t = 0; t < config->threads; t++) {
+        workers[t].index = t;
+        workers[t].config = config;
+        workers[t].system = system;
+        workers[t].backend = backend;
+        workers[t].perf = perf;
+        Histogram_init(&workers[t].creation_latencies, 1);
+        Histogram_init(&workers[t].cleanup_latencies, 1);
+    }
+
+    INFO("Churn\n");
+    Run_begin(run, perf, EXECUTION);
+    MemorySampler_start(&run->memory_sampler, config->memory_sample_interval * 1000000);
+    if (config->threads == 1) {
+        ChurnWorker_run(&workers[0]);
+    } else {
+        pthread_t *threads = (pthread_t *) malloc(sizeof(pthread_t) * config->threads);
+        pthread_barrier_t barrier;
+        pthread_barrier_init(&barrier, NULL, config->threads + 1);
+        for (size_t t = 0; t < config->threads; t++) {
+            workers[t].barrier = &barrier;
+            if (0 != pthread_create(&threads[t], NULL, ChurnWorker_run, &workers[t])) {
+                REPORT("Cannot start churn thread %lu\n", t);
+                exit(6);
+            }
+        }
+        pthread_barrier_wait(&barrier);
+        for (size_t t = 0; t < config->threads; t++) {
+            pthread_join(threads[t], NULL);
+        }
+        pthread_barrier_destroy(&barrier);
+        free(threads);
+    }
+    MemorySampler_stop(&run->memory_sampler);
+    Run_end(run, perf, EXECUTION);
+
+    // As in Run_execute, time is taken from the workers' own clocks.
+    uint64_t execution_start_time = UINT64_MAX, execution_end_time = 0;
+    size_t failures = 0;
+    Histogram_init(&run->creation_latencies, 1);
+    Histogram_init(&run->cleanup_latencies, 1);
+    run->thread_execution_times = (uint64_t *) malloc(sizeof(uint64_t) * config->threads);
+    for (size_t t = 0; t < config->threads; t++) {
+        uint64_t end_time = workers[t].start_time + workers[t].elapsed_time;
+        if (workers[t].start_time < execution_start_time) execution_start_time = workers[t].start_time;
+        if (end_time > execution_end_time) execution_end_time = end_time;
+        run->thread_execution_times[t] = workers[t].elapsed_time;
+        Histogram_merge(&run->creation_latencies, &workers[t].creation_latencies);
+        Histogram_merge(&run->cleanup_latencies, &workers[t].cleanup_latencies);
+        failures += workers[t].failures;
+    }
+    free(workers);
+    if (failures != 0) {
+        WARN("Failed to create %lu of %lu objects\n", failures, config->churn * config->threads);
+    }
+
+    run->elapsed_time[EXECUTION] = execution_end_time - execution_start_time;
+    run->objects_churned = config->churn * config->threads - failures;
+    run->sequence_length = run->objects_churned;
+    run->throughput = run->elapsed_time[EXECUTION] == 0 ? 0 
+        : ((double) run->objects_churned) * 1000000000.0 / ((double) run->elapsed_time[EXECUTION]);
+    return 0;
+}
+
+// The lookup benchmark grows a population of ufo seq objects, with lengths
+// drawn log-uniformly from [1, size], through every size in --populations.
+// At each of them it times --lookups address lookups of random objects, at
+// their first element and at a random element inside, then frees up to
+// --lookups random objects, timing that too, and recreates them.
+int Run_lookup(Run *run, PerfCounters *perf, Arguments *config, AnySystem system, size_t *populations, size_t populations_count) {
+    size_t max_population = populations[populations_count - 1];
+    int64_t **objects = (int64_t **) malloc(sizeof(int64_t *) * max_population);
+    size_t *lengths = (size_t *) malloc(sizeof(size_t) * max_population);
+    size_t *freed = (size_t *) malloc(sizeof(size_t) * (config->lookups < max_population ? config->lookups : max_population));
+    size_t live = 0;
+    double log_size = log((double) config->size);
+
+    run->lookup_results = (LookupResult *) calloc(populations_count, sizeof(LookupResult));
+    run->lookup_results_count = populations_count;
+    uint64_t lookup_time = 0;
+    int status = 0;
+
+    INFO("Lookup\n");
+    Run_begin(run, perf, EXECUTION);
+    MemorySampler_start(&run->memory_sampler, config->memory_sample_interval * 1000000);
+    for (size_t p = 0; p < populations_count && status == 0; p++) {
+        LookupResult *result = &run->lookup_results[p];
+        result->population = populations[p];
+        Histogram_init(&result->creation_latencies, 1);
+        Histogram_init(&result->lookup_latencies, 1);
+        Histogram_init(&result->interior_latencies, 1);
+        Histogram_init(&result->cleanup_latencies, 1);
+        INFO("  * population %lu\n", result->population);
+
+        for (; live < result->population; live++) {
+            lengths[live] = (size_t) exp(random_uniform() * log_size);
+            if (lengths[live] == 0) lengths[live] = 1;
+            uint64_t start_time = current_time_in_ns();
+            objects[live] = (int64_t *) ufo_lookup_creation(config, system, lengths[live]);
+            Histogram_record(&result->creation_latencies, current_time_in_ns() - start_time);
+            if (objects[live] == NULL) {
+                REPORT("Cannot create object %lu of the population\n", live);
+                status = 8;
+                break;
+            }
+        }
+        if (status != 0) {
+            break;
+        }
+
+        for (size_t i = 0; i < config->lookups; i++) {
+            int64_t *object = objects[random_index(live)];
+            uint64_t start_time = current_time_in_ns();
+            bool found = ufo_lookup(system, object);
+            uint64_t elapsed_time = current_time_in_ns() - start_time;
+            Histogram_record(&result->lookup_latencies, elapsed_time);
+            lookup_time += elapsed_time;
+            result->failures += found ? 0 : 1;
+
+            size_t index = random_index(live);
+            int64_t *element = objects[index] + random_index(lengths[index]);
+            start_time = current_time_in_ns();
+            found = ufo_lookup(system, element);
+            elapsed_time = current_time_in_ns() - start_time;
+            Histogram_record(&result->interior_latencies, elapsed_time);
+            lookup_time += elapsed_time;
+            result->failures += found ? 0 : 1;
+        }
+
+        // Free random objects, keeping the rest of the population in place
+        // by moving the last object into the gap.
+        size_t frees = config->lookups < live ? config->lookups : live;
+        for (size_t i = 0; i < frees; i++) {
+            size_t index = random_index(live);
+            uint64_t start_time = current_time_in_ns();
+            ufo_seq_cleanup(config, system, objects[index]);
+            Histogram_record(&result->cleanup_latencies, current_time_in_ns() - start_time);
+            freed[i] = lengths[index];
+            live--;
+            objects[index] = objects[live];
+            lengths[index] = lengths[live];
+        }
+        for (size_t i = 0; i < frees; i++, live++) {
+            lengths[live] = freed[i];
+            objects[live] = (int64_t *) ufo_lookup_creation(config, system, lengths[live]);
+            if (objects[live] == NULL) {
+                REPORT("Cannot recreate object %lu of the population\n", live);
+                status = 8;
+                break;
+            }
+        }
+        if (result->failures != 0) {
+            WARN("%lu lookups failed at population %lu\n", result->failures, result->population);
+        }
+    }
+    MemorySampler_stop(&run->memory_sampler);
+    Run_end(run, perf, EXECUTION);
+
+    // On failure `live` stops at the object that could not be created, so
+    // this frees exactly the population built so far.
+    for (size_t i = 0; i < live; i++) {
+        ufo_seq_cleanup(config, system, objects[i]);
+    }
+    free(objects);
+    free(lengths);
+    free(freed);
+    if (status != 0) {
+        return status;
+    }
+
+    run->thread_execution_times = (uint64_t *) malloc(sizeof(uint64_t));
+    run->thread_execution_times[0] = run->elapsed_time[EXECUTION];
+    run->sequence_length = max_population;
+    // Lookups per second, not counting the time spent creating and freeing.
+    run->throughput = lookup_time == 0 ? 0 
+        : ((double) (2 * config->lookups * populations_count)) * 1000000000.0 / ((double) lookup_time);
+    return 0;
+}
+
+void Run_write_header(FILE *output_stream) {
+    fprintf(output_stream, 
+           "benchmark,"
+           "implementation,"
+           "pattern,"
+           "min_load_count,"
+           "size,"
+           "writes,"
+           "system_setup_time,"
+           "object_creation_time,"
+           "execution_time,"
+           "object_cleanup_time,"
+           "system_teardown_time,"
+           "threads,"
+           "throughput,"
+           "latency_samples,"
+           "latency_p50,"
+           "latency_p90,"
+           "latency_p99,"
+           "latency_p999,"
+           "latency_max,");
+    for (Phase phase = 0; phase < PHASES; phase++) {
+        fprintf(output_stream, "%s_minor_faults,%s_major_faults,%s_rss,%s_written_bytes,%s_storage_written_bytes,", 
+                phase_names[phase], phase_names[phase], phase_names[phase], phase_names[phase], phase_names[phase]);
+    }
+    for (Phase phase = 0; phase < PHASES; phase++) {
+        for (PerfCounter counter = 0; counter < PERF_COUNTERS; counter++) {
+            fprintf(output_stream, "%s_%s,", phase_names[phase], perf_counter_names[counter]);
+        }
+    }
+    for (Phase phase = 0; phase < PHASES; phase++) {
+        fprintf(output_stream, "%s_populate_calls,%s_populate_bytes,%s_populate_time,", 
+                phase_names[phase], phase_names[phase], phase_names[phase]);
+    }
+    fprintf(output_stream, 
+           "execution_peak_rss,"
+           "execution_average_rss,"
+           "vm_hwm,"
+           "write_mode,"
+           "write_accesses,"
+           "dirty_chunks,"
+           "read_only_execution_time,"
+           "writeback_slowdown,"
+           "execution_populate_threads,"
+           "mix_objects,"
+           "churn_objects,"
+           "live_objects,"
+           "creation_latency_p50,"
+           "creation_latency_p90,"
+           "creation_latency_p99,"
+           "creation_latency_p999,"
+           "creation_latency_max,"
+           "cleanup_latency_p50,"
+           "cleanup_latency_p90,"
+           "cleanup_latency_p99,"
+           "cleanup_latency_p999,"
+           "cleanup_latency_max,"
+           "lookup_populations,"
+           "memory_max,"
+           "memory_events_high,"
+           "memory_events_max,"
+           "memory_events_oom,"
+           "memory_events_oom_kill,"
+           "cgroup_memory_peak,"
+           "cgroup_swap_current,"
+           "cgroup_swap_peak,"
+           "execution_swap,"
+           "cache_state,"
+           "file_cached_bytes,"
+           "element,"
+           "repetition,"
+           "thread_execution_times\n");
+}
 
-SequenceResult ScanSequence_next(Arguments *config, AnySequence sequence) {
-    ScanSequence *scan_sequence = (ScanSequence *) sequence;
-    SequenceResult result;
-    result.end = !(scan_sequence->current < scan_sequence->length);
-    result.current = scan_sequence->current;
-    if (scan_sequence->since_last_write == 1) {
-        result.write = true;
-        scan_sequence->since_last_write = config->writes;
+void Run_write(FILE *output_stream, PerfCounters *perf, Run *runs, size_t count, size_t index) {
+    Run *run = &runs[index];
+    Arguments *config = &run->config;
+    Run *phase_runs[PHASES];
+    for (Phase phase = 0; phase < PHASES; phase++) {
+        phase_runs[phase] = Run_of_phase(runs, count, index, phase);
+    }
+
+    fprintf(output_stream,
+        "%s,%s,%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%.2f,%lu,%lu,%lu,%lu,%lu,%lu,",
+        config->benchmark,
+        config->implementation,
+        config->pattern,
+        (strcmp("ufo", config->implementation) == 0) ? config->min_load : 0, // Only if it matters
+        run->sequence_length,
+        config->writes,
+        phase_runs[SYSTEM_SETUP]->elapsed_time[SYSTEM_SETUP],
+        phase_runs[OBJECT_CREATION]->elapsed_time[OBJECT_CREATION],
+        phase_runs[EXECUTION]->elapsed_time[EXECUTION],
+        phase_runs[OBJECT_CLEANUP]->elapsed_time[OBJECT_CLEANUP],
+        phase_runs[SYSTEM_TEARDOWN]->elapsed_time[SYSTEM_TEARDOWN],
+        config->threads,
+        run->throughput,
+        run->latencies.count,
+        Histogram_percentile(&run->latencies, 50),
+        Histogram_percentile(&run->latencies, 90),
+        Histogram_percentile(&run->latencies, 99),
+        Histogram_percentile(&run->latencies, 99.9),
+        run->latencies.max);
+
+    // Faults and bytes written during each phase and resident set size at its end.
+    for (Phase phase = 0; phase < PHASES; phase++) {
+        Run *phase_run = phase_runs[phase];
+        fprintf(output_stream, "%lu,%lu,%lu,%lu,%lu,",
+            phase_run->memory_after[phase].minor_faults - phase_run->memory_before[phase].minor_faults,
+            phase_run->memory_after[phase].major_faults - phase_run->memory_before[phase].major_faults,
+            phase_run->memory_after[phase].rss,
+            phase_run->memory_after[phase].written - phase_run->memory_before[phase].written,
+            phase_run->memory_after[phase].storage_written - phase_run->memory_before[phase].storage_written);
+    }
+
+    // Perf counters for each phase, empty where unavailable.
+    for (Phase phase = 0; phase < PHASES; phase++) {
+        Run *phase_run = phase_runs[phase];
+        for (PerfCounter counter = 0; counter < PERF_COUNTERS; counter++) {
+            if (PerfCounters_available(perf, counter)) {
+                fprintf(output_stream, "%lu,", 
+                    PerfReading_delta(&phase_run->perf_before[phase], &phase_run->perf_after[phase], counter));
+            } else {
+                fprintf(output_stream, ",");
+            }
+        }
+    }
+    // Time spent inside populate callbacks during each phase.
+    for (Phase phase = 0; phase < PHASES; phase++) {
+        PopulateCounters populate;
+        Run_populate(phase_runs[phase], phase, &populate);
+        fprintf(output_stream, "%lu,%lu,%lu,", populate.calls, populate.bytes, populate.time);
+    }
+    fprintf(output_stream, "%lu,%lu,%lu,%s,%lu,%lu,",
+        run->memory_sampler.peak_rss,
+        MemorySampler_average_rss(&run->memory_sampler),
+        phase_runs[SYSTEM_TEARDOWN]->memory_after[SYSTEM_TEARDOWN].hwm,
+        config->write_mode,
+        run->write_accesses,
+        run->dirty_chunks);
+    if (run->read_only_time != 0) {
+        fprintf(output_stream, "%lu,%.4f,", run->read_only_time, Run_writeback_slowdown(run));
     } else {
-        result.write = false;
-        scan_sequence->since_last_write--;
+        fprintf(output_stream, ",,");
     }
-    scan_sequence->current++;
-    return result;
-}
 
-typedef struct { 
-    size_t current; 
-    size_t since_last_write; 
-} ReverseSequence;
+    // Populating threads as tid:calls:bytes:time, separated by semicolons.
+    // Tid 0 is the overflow slot shared by threads that found no free slot.
+    for (size_t i = 0; i < run->populate_threads_count; i++) {
+        PopulateThread *thread = &run->populate_threads[i];
+        fprintf(output_stream, i == 0 ? "%d:%lu:%lu:%lu" : ";%d:%lu:%lu:%lu", thread->tid,
+            thread->counters.calls, thread->counters.bytes, thread->counters.time);
+    }
+    fprintf(output_stream, ",");
 
-SequenceResult ReverseSequence_next(Arguments *config, AnySequence sequence) {
-    ReverseSequence *reverse_sequence = (ReverseSequence *) sequence;
-    SequenceResult result;
-    result.end = !(reverse_sequence->current > 0);
-    if (reverse_sequence->since_last_write == 1) {
-        result.write = true;
-        reverse_sequence->since_last_write = config->writes;
+    // Objects of the mix benchmark as 
+    // benchmark:weight:accesses:time:populate_calls:populate_bytes:populate_time.
+    for (size_t i = 0; i < run->mix_results_count; i++) {
+        MixResult *result = &run->mix_results[i];
+        fprintf(output_stream, i == 0 ? "%s:%lu:%lu:%lu:%lu:%lu:%lu" : ";%s:%lu:%lu:%lu:%lu:%lu:%lu", 
+            result->benchmark, result->weight, result->accesses, result->time,
+            result->populate.calls, result->populate.bytes, result->populate.time);
+    }
+    fprintf(output_stream, ",");
+
+    // Creation and cleanup latencies of the churn benchmark.
+    if (run->objects_churned != 0) {
+        fprintf(output_stream, "%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,",
+            run->objects_churned,
+            config->live,
+            Histogram_percentile(&run->creation_latencies, 50),
+            Histogram_percentile(&run->creation_latencies, 90),
+            Histogram_percentile(&run->creation_latencies, 99),
+            Histogram_percentile(&run->creation_latencies, 99.9),
+            run->creation_latencies.max,
+            Histogram_percentile(&run->cleanup_latencies, 50),
+            Histogram_percentile(&run->cleanup_latencies, 90),
+            Histogram_percentile(&run->cleanup_latencies, 99),
+            Histogram_percentile(&run->cleanup_latencies, 99.9),
+            run->cleanup_latencies.max);
     } else {
-        result.write = false;
-        reverse_sequence->since_last_write--;
+        fprintf(output_stream, ",,,,,,,,,,,,");
     }
-    reverse_sequence->current--;
-    result.current = reverse_sequence->current;
-    return result;
-}
 
-typedef struct { 
-    size_t generated; 
-    size_t length;
-    size_t max_length;
-    size_t since_last_write; 
-} RandomSequence;
+    // Lookup benchmark populations as population:creation_p50:lookup_p50:
+    // lookup_p99:interior_p50:interior_p99:cleanup_p50:cleanup_p99.
+    for (size_t i = 0; i < run->lookup_results_count; i++) {
+        LookupResult *result = &run->lookup_results[i];
+        fprintf(output_stream, i == 0 ? "%lu:%lu:%lu:%lu:%lu:%lu:%lu:%lu" : ";%lu:%lu:%lu:%lu:%lu:%lu:%lu:%lu",
+            result->population,
+            Histogram_percentile(&result->creation_latencies, 50),
+            Histogram_percentile(&result->lookup_latencies, 50),
+            Histogram_percentile(&result->lookup_latencies, 99),
+            Histogram_percentile(&result->interior_latencies, 50),
+            Histogram_percentile(&result->interior_latencies, 99),
+            Histogram_percentile(&result->cleanup_latencies, 50),
+            Histogram_percentile(&result->cleanup_latencies, 99));
+    }
+    fprintf(output_stream, ",");
 
-SequenceResult RandomSequence_next(Arguments *config, AnySequence sequence) {
-    RandomSequence *random_sequence = (RandomSequence *) sequence;
-    SequenceResult result;
-    result.end = !(random_sequence->generated < random_sequence->length);
-    result.current = random_index(random_sequence->max_length);
-    if (random_sequence->since_last_write == 1) {
-        result.write = true;
-        random_sequence->since_last_write = config->writes;
+    // Memory limit and what the cgroup saw, empty if there was no limit.
+    if (run->constrained) {
+        fprintf(output_stream, "%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,",
+            config->memory_max,
+            run->cgroup.high,
+            run->cgroup.max,
+            run->cgroup.oom,
+            run->cgroup.oom_kill,
+            run->cgroup.memory_peak,
+            run->cgroup.swap_current,
+            run->cgroup.swap_peak);
     } else {
-        result.write = false;
-        random_sequence->since_last_write--;
+        fprintf(output_stream, ",,,,,,,,");
     }
-    random_sequence->generated++;
-    return result;
-}
+    fprintf(output_stream, "%lu,%s,%lu,%s,%lu,", run->memory_after[EXECUTION].swap, 
+        config->cache_state, phase_runs[OBJECT_CREATION]->file_cached, config->element, run->repetition);
 
-// MAX LENGTHS
-size_t fib_max_length(Arguments *config, AnySystem system, AnyObject object) {
-    return config->size;
-}
-size_t bzip_max_length(Arguments *config, AnySystem system, AnyObject object) {
-    BZip2 *bzip2 = (BZip2 *) object;
-    return bzip2->size;
-}
-size_t seq_max_length(Arguments *config, AnySystem system, AnyObject object) {
-    return config->size;
-}
-size_t psql_max_length(Arguments *config, AnySystem system, AnyObject object) {
-    Players *players = (Players *) object;
-    return players->size;
-}
-size_t mmap_max_length(Arguments *config, AnySystem system, AnyObject object) {
-    MMap *mmap = (MMap *) object;
-    return mmap->size;
-}
-size_t col_max_length(Arguments *config, AnySystem system, AnyObject object) {
-    return config->size;
+    // Per-thread execution times, separated by semicolons to fit in one column.
+    for (size_t t = 0; t < config->threads; t++) {
+        fprintf(output_stream, t == 0 ? "%lu" : ";%lu", run->thread_execution_times[t]);
+    }
+    fprintf(output_stream, "\n");
 }
 
-// EXECUTION
-// Fibonacci
-void fib_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette) {
-    uint64_t *data = (uint64_t *) object;    
-    uint64_t sum = 0;
-    SequenceResult result;
-    while (true) {
-        result = next(config, sequence);        
-        if (result.end) {
-            break;
-        }
-        if (result.write) {
-            data[result.current] = random_int(1000);
+// Writes a JSON string literal.
+static void json_string(FILE *output_stream, const char *string) {
+    fputc('"', output_stream);
+    for (const char *c = string == NULL ? "" : string; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            fprintf(output_stream, "\\%c", *c);
+        } else if ((unsigned char) *c < 0x20) {
+            fprintf(output_stream, "\\u%04x", (unsigned char) *c);
         } else {
-            sum += data[result.current];
+            fputc(*c, output_stream);
         }
-    };
-    *oubliette = sum;
+    }
+    fputc('"', output_stream);
 }
 
-// BZip2
-void bzip_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette) {
-    BZip2 *bzip = (BZip2 *) object;    
-    uint64_t sum = 0;
-    SequenceResult result;
-    while (true) {
-        result = next(config, sequence);        
-        if (result.end) {
-            break;
-        }        
-        if (result.write) {
-            bzip->data[result.current] = random_int(126 - 32) + 32;
-        } else {
-            sum += bzip->data[result.current];
+// One JSON object per line: the full configuration, the environment, and
+// every measurement taken in one repetition.
+void Run_write_json(FILE *output_stream, Environment *environment, PerfCounters *perf, Run *runs, size_t count, size_t index) {
+    Run *run = &runs[index];
+    Arguments *config = &run->config;
+    Run *phase_runs[PHASES];
+    for (Phase phase = 0; phase < PHASES; phase++) {
+        phase_runs[phase] = Run_of_phase(runs, count, index, phase);
+    }
+
+    fprintf(output_stream, "{\"arguments\":{\"benchmark\":");
+    json_string(output_stream, config->benchmark);
+    fprintf(output_stream, ",\"implementation\":");
+    json_string(output_stream, config->implementation);
+    fprintf(output_stream, ",\"pattern\":");
+    json_string(output_stream, config->pattern);
+    fprintf(output_stream, ",\"file\":");
+    json_string(output_stream, config->file);
+    fprintf(output_stream, ",\"cache_state\":");
+    json_string(output_stream, config->cache_state);
+    fprintf(output_stream, ",\"element\":");
+    json_string(output_stream, config->element);
+    if (rep_benchmark_known(config->benchmark)) {
+        fprintf(output_stream, ",\"base\":%lu", config->base);
+    }
+    if (strcmp(config->benchmark, "fib") == 0) {
+        fprintf(output_stream, ",\"fib_mode\":");
+        json_string(output_stream, config->fib_mode_name);
+    }
+    if (strcmp(config->implementation, "mmapfile") == 0) {
+        fprintf(output_stream, ",\"mmapfile_dir\":");
+        json_string(output_stream, config->mmapfile_directory);
+    }
+    if (run->mix_results_count > 0) {
+        fprintf(output_stream, ",\"objects\":");
+        json_string(output_stream, config->objects);
+        fprintf(output_stream, ",\"quantum\":%lu", config->quantum);
+    }
+    if (run->objects_churned != 0) {
+        fprintf(output_stream, ",\"churn_object\":");
+        json_string(output_stream, config->churn_object);
+        fprintf(output_stream, ",\"churn\":%lu,\"live\":%lu", config->churn, config->live);
+    }
+    if (run->lookup_results_count > 0) {
+        fprintf(output_stream, ",\"populations\":");
+        json_string(output_stream, config->population_list);
+        fprintf(output_stream, ",\"lookups\":%lu", config->lookups);
+    }
+    fprintf(output_stream, ",\"write_mode\":");
+    json_string(output_stream, config->write_mode);
+    fprintf(output_stream, ",\"burst\":%lu,\"write_region\":%g,\"write_baseline\":%s", 
+        config->burst, config->write_region, config->write_baseline ? "true" : "false");
+    fprintf(output_stream, 
+        ",\"size\":%lu,\"sample_size\":%lu,\"min_load\":%lu,\"high_water_mark\":%lu,\"low_water_mark\":%lu,\"memory_max\":%lu"
+        ",\"writes\":%lu,\"threads\":%lu,\"zipf_exponent\":%g,\"hot_accesses\":%g,\"hot_data\":%g"
+        ",\"stride\":%lu,\"window\":%lu,\"latency_sample\":%lu,\"memory_sample_interval\":%lu"
+        ",\"perf\":%s,\"instrument\":%s,\"repeat\":%lu,\"warmup\":%lu,\"reuse\":%s,\"seed\":%u,\"pregenerate\":%s}",
+        config->size, config->sample_size, config->min_load, config->high_water_mark, config->low_water_mark, config->memory_max,
+        config->writes, config->threads, config->zipf_exponent, config->hot_accesses, config->hot_data,
+        config->stride, config->window, config->latency_sample, config->memory_sample_interval,
+        config->perf ? "true" : "false", config->instrument ? "true" : "false", config->repeat, config->warmup, config->reuse ? "true" : "false", 
+        config->seed, config->pregenerate ? "true" : "false");
+
+    fprintf(output_stream, ",\"environment\":{\"hostname\":");
+    json_string(output_stream, environment->hostname);
+    fprintf(output_stream, ",\"kernel\":");
+    json_string(output_stream, environment->kernel);
+    fprintf(output_stream, ",\"machine\":");
+    json_string(output_stream, environment->machine);
+    fprintf(output_stream, ",\"cpu_model\":");
+    json_string(output_stream, environment->cpu_model);
+    fprintf(output_stream, ",\"cores\":%ld,\"transparent_hugepages\":", environment->cores);
+    json_string(output_stream, environment->transparent_hugepages);
+    fprintf(output_stream, ",\"unprivileged_userfaultfd\":%d,\"tmp_filesystem\":", 
+        environment->unprivileged_userfaultfd);
+    json_string(output_stream, environment->tmp_filesystem);
+    fprintf(output_stream, ",\"timestamp\":");
+    json_string(output_stream, environment->timestamp);
+    fprintf(output_stream, "}");
+
+    fprintf(output_stream, ",\"repetition\":%lu,\"sequence_length\":%lu", run->repetition, run->sequence_length);
+    for (Phase phase = 0; phase < PHASES; phase++) {
+        fprintf(output_stream, ",\"%s_time\":%lu", phase_names[phase], phase_runs[phase]->elapsed_time[phase]);
+    }
+    fprintf(output_stream, 
+        ",\"throughput\":%.2f,\"latency\":{\"samples\":%lu,\"p50\":%lu,\"p90\":%lu,\"p99\":%lu,\"p999\":%lu,\"max\":%lu}",
+        run->throughput,
+        run->latencies.count,
+        Histogram_percentile(&run->latencies, 50),
+        Histogram_percentile(&run->latencies, 90),
+        Histogram_percentile(&run->latencies, 99),
+        Histogram_percentile(&run->latencies, 99.9),
+        run->latencies.max);
+
+    fprintf(output_stream, ",\"phases\":{");
+    for (Phase phase = 0; phase < PHASES; phase++) {
+        Run *phase_run = phase_runs[phase];
+        fprintf(output_stream, 
+            "%s\"%s\":{\"minor_faults\":%lu,\"major_faults\":%lu,\"rss\":%lu"
+            ",\"swap\":%lu,\"written_bytes\":%lu,\"storage_written_bytes\":%lu", 
+            phase == 0 ? "" : ",", phase_names[phase],
+            phase_run->memory_after[phase].minor_faults - phase_run->memory_before[phase].minor_faults,
+            phase_run->memory_after[phase].major_faults - phase_run->memory_before[phase].major_faults,
+            phase_run->memory_after[phase].rss,
+            phase_run->memory_after[phase].swap,
+            phase_run->memory_after[phase].written - phase_run->memory_before[phase].written,
+            phase_run->memory_after[phase].storage_written - phase_run->memory_before[phase].storage_written);
+        PopulateCounters populate;
+        Run_populate(phase_run, phase, &populate);
+        fprintf(output_stream, ",\"populate_calls\":%lu,\"populate_bytes\":%lu,\"populate_time\":%lu",
+            populate.calls, populate.bytes, populate.time);
+        for (PerfCounter counter = 0; counter < PERF_COUNTERS; counter++) {
+            if (PerfCounters_available(perf, counter)) {
+                fprintf(output_stream, ",\"%s\":%lu", perf_counter_names[counter],
+                    PerfReading_delta(&phase_run->perf_before[phase], &phase_run->perf_after[phase], counter));
+            }
         }
-    };
-    *oubliette = sum;
-}
+        fprintf(output_stream, "}");
+    }
+    fprintf(output_stream, "}");
 
-// Seq
-void seq_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette) {
-    int64_t *data = (int64_t *) object;    
-    int64_t sum = 0;
-    SequenceResult result;
-    while (true) {
-        result = next(config, sequence);        
-        if (result.end) {
-            break;
-        }        
-        if (result.write) {
-            data[result.current] = random_int(1000);
-        } else {
-            sum += data[result.current];
+    fprintf(output_stream, ",\"execution_peak_rss\":%lu,\"execution_average_rss\":%lu,\"vm_hwm\":%lu",
+        run->memory_sampler.peak_rss,
+        MemorySampler_average_rss(&run->memory_sampler),
+        phase_runs[SYSTEM_TEARDOWN]->memory_after[SYSTEM_TEARDOWN].hwm);
+    fprintf(output_stream, ",\"write_accesses\":%lu,\"dirty_chunks\":%lu", run->write_accesses, run->dirty_chunks);
+    fprintf(output_stream, ",\"file_cached_bytes\":%lu,\"caches_dropped\":%s", 
+        phase_runs[OBJECT_CREATION]->file_cached, phase_runs[OBJECT_CREATION]->caches_dropped ? "true" : "false");
+    if (run->read_only_time != 0) {
+        fprintf(output_stream, ",\"read_only_execution_time\":%lu,\"writeback_slowdown\":%.4f", 
+            run->read_only_time, Run_writeback_slowdown(run));
+    }
+    if (run->constrained) {
+        fprintf(output_stream, 
+            ",\"cgroup\":{\"memory_max\":%lu,\"low\":%lu,\"high\":%lu,\"max\":%lu,\"oom\":%lu,\"oom_kill\":%lu"
+            ",\"memory_current\":%lu,\"memory_peak\":%lu,\"swap_current\":%lu,\"swap_peak\":%lu"
+            ",\"phases\":%s,\"object_constrained\":%s}",
+            config->memory_max, run->cgroup.low, run->cgroup.high, run->cgroup.max, run->cgroup.oom, run->cgroup.oom_kill,
+            run->cgroup.memory_current, run->cgroup.memory_peak, run->cgroup.swap_current, run->cgroup.swap_peak,
+            run->creation_constrained ? "[\"object_creation\",\"execution\"]" : "[\"execution\"]",
+            run->creation_constrained ? "true" : "false");
+    }
+
+    fprintf(output_stream, ",\"populate_threads\":[");
+    for (size_t i = 0; i < run->populate_threads_count; i++) {
+        PopulateThread *thread = &run->populate_threads[i];
+        fprintf(output_stream, "%s{\"tid\":%d,\"backend\":", i == 0 ? "" : ",", thread->tid);
+        json_string(output_stream, thread->backend);
+        fprintf(output_stream, ",\"overflow\":%s,\"calls\":%lu,\"bytes\":%lu,\"time\":%lu}",
+            thread->overflow ? "true" : "false",
+            thread->counters.calls, thread->counters.bytes, thread->counters.time);
+    }
+    fprintf(output_stream, "]");
+
+    if (run->mix_results_count > 0) {
+        fprintf(output_stream, ",\"objects\":[");
+        for (size_t i = 0; i < run->mix_results_count; i++) {
+            MixResult *result = &run->mix_results[i];
+            fprintf(output_stream, "%s{\"benchmark\":", i == 0 ? "" : ",");
+            json_string(output_stream, result->benchmark);
+            fprintf(output_stream, 
+                ",\"weight\":%lu,\"accesses\":%lu,\"turns\":%lu,\"time\":%lu,\"throughput\":%.2f"
+                ",\"populate_calls\":%lu,\"populate_bytes\":%lu,\"populate_time\":%lu,\"dirty_chunks\":%lu}",
+                result->weight, result->accesses, result->turns, result->time, result->throughput,
+                result->populate.calls, result->populate.bytes, result->populate.time, result->dirty_chunks);
         }
-    };
-    *oubliette = sum;
-}
+        fprintf(output_stream, "]");
+    }
 
-// PSQL
-void psql_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette) {
-    Players *players = (Players *) object;    
-    int64_t tds = 0;
-    int64_t mvp = 0;
-    SequenceResult result;
-    while (true) {
-        result = next(config, sequence);        
-        if (result.end) {
-            break;
-        }        
-        if (result.write) {
-            players->data[result.current].tds = random_int(100);
-            players->data[result.current].mvp = random_int(100);
-        } else {
-            tds += players->data[result.current].tds;
-            mvp += players->data[result.current].mvp;
+    if (run->objects_churned != 0) {
+        Histogram *histograms[] = { &run->creation_latencies, &run->cleanup_latencies };
+        const char *names[] = { "creation_latency", "cleanup_latency" };
+        fprintf(output_stream, ",\"objects_churned\":%lu", run->objects_churned);
+        for (size_t i = 0; i < 2; i++) {
+            fprintf(output_stream, 
+                ",\"%s\":{\"samples\":%lu,\"p50\":%lu,\"p90\":%lu,\"p99\":%lu,\"p999\":%lu,\"max\":%lu}",
+                names[i],
+                histograms[i]->count,
+                Histogram_percentile(histograms[i], 50),
+                Histogram_percentile(histograms[i], 90),
+                Histogram_percentile(histograms[i], 99),
+                Histogram_percentile(histograms[i], 99.9),
+                histograms[i]->max);
         }
-    };
-    *oubliette = tds + mvp;
+    }
+
+    if (run->lookup_results_count > 0) {
+        fprintf(output_stream, ",\"lookup\":[");
+        for (size_t i = 0; i < run->lookup_results_count; i++) {
+            LookupResult *result = &run->lookup_results[i];
+            Histogram *histograms[] = { 
+                &result->creation_latencies, &result->lookup_latencies, 
+                &result->interior_latencies, &result->cleanup_latencies 
+            };
+            const char *names[] = { "creation_latency", "lookup_latency", "interior_lookup_latency", "cleanup_latency" };
+            fprintf(output_stream, "%s{\"population\":%lu,\"failures\":%lu", 
+                i == 0 ? "" : ",", result->population, result->failures);
+            for (size_t h = 0; h < 4; h++) {
+                fprintf(output_stream, 
+                    ",\"%s\":{\"samples\":%lu,\"p50\":%lu,\"p90\":%lu,\"p99\":%lu,\"p999\":%lu,\"max\":%lu}",
+                    names[h],
+                    histograms[h]->count,
+                    Histogram_percentile(histograms[h], 50),
+                    Histogram_percentile(histograms[h], 90),
+                    Histogram_percentile(histograms[h], 99),
+                    Histogram_percentile(histograms[h], 99.9),
+                    histograms[h]->max);
+            }
+            fprintf(output_stream, "}");
+        }
+        fprintf(output_stream, "]");
+    }
+
+    fprintf(output_stream, ",\"thread_execution_times\":[");
+    for (size_t t = 0; t < config->threads; t++) {
+        fprintf(output_stream, t == 0 ? "%lu" : ",%lu", run->thread_execution_times[t]);
+    }
+    fprintf(output_stream, "],\"oubliette\":%ld}\n", run->oubliette);
 }
 
-// MMap
-void mmap_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette) {
-    MMap *bzip = (MMap *) object;    
-    uint64_t sum = 0;
-    SequenceResult result;
-    while (true) {
-        result = next(config, sequence);        
-        if (result.end) {
-            break;
-        }        
-        if (result.write) {
-            bzip->data[result.current] = random_int(126 - 32) + 32;
-        } else {
-            sum += bzip->data[result.current];
+void Run_report(PerfCounters *perf, Run *runs, size_t count, size_t index) {
+    Run *run = &runs[index];
+    Arguments *config = &run->config;
+    Run *phase_runs[PHASES];
+    for (Phase phase = 0; phase < PHASES; phase++) {
+        phase_runs[phase] = Run_of_phase(runs, count, index, phase);
+    }
+
+    INFO("Results (pattern=%s sample_size=%lu writes=%lu):\n", 
+        config->pattern, config->sample_size, config->writes);
+    INFO("  * system_setup:    %12luns\n", phase_runs[SYSTEM_SETUP]->elapsed_time[SYSTEM_SETUP]);
+    INFO("  * object_creation: %12luns\n", phase_runs[OBJECT_CREATION]->elapsed_time[OBJECT_CREATION]);
+    INFO("  * execution:       %12luns\n", phase_runs[EXECUTION]->elapsed_time[EXECUTION]);
+    INFO("  * object_cleanup:  %12luns\n", phase_runs[OBJECT_CLEANUP]->elapsed_time[OBJECT_CLEANUP]);
+    INFO("  * object_teardown: %12luns\n", phase_runs[SYSTEM_TEARDOWN]->elapsed_time[SYSTEM_TEARDOWN]);
+    INFO("  * throughput:      %12.0f/s\n", run->throughput);
+    for (size_t t = 0; t < config->threads && config->threads > 1; t++) {
+        INFO("    - thread %-4lu     %12luns\n", t, run->thread_execution_times[t]);
+    }
+    INFO("  * latency p50:     %12luns\n", Histogram_percentile(&run->latencies, 50));
+    INFO("  * latency p90:     %12luns\n", Histogram_percentile(&run->latencies, 90));
+    INFO("  * latency p99:     %12luns\n", Histogram_percentile(&run->latencies, 99));
+    INFO("  * latency p99.9:   %12luns\n", Histogram_percentile(&run->latencies, 99.9));
+    INFO("  * latency max:     %12luns (%lu samples)\n", run->latencies.max, run->latencies.count);
+    for (Phase phase = 0; phase < PHASES; phase++) {
+        Run *phase_run = phase_runs[phase];
+        INFO("  * %-16s %9lu minor faults, %6lu major faults, %12luB RSS after, %12luB swapped, %12luB written\n", phase_names[phase],
+            phase_run->memory_after[phase].minor_faults - phase_run->memory_before[phase].minor_faults,
+            phase_run->memory_after[phase].major_faults - phase_run->memory_before[phase].major_faults,
+            phase_run->memory_after[phase].rss,
+            phase_run->memory_after[phase].swap,
+            phase_run->memory_after[phase].written - phase_run->memory_before[phase].written);
+    }
+    for (Phase phase = 0; phase < PHASES; phase++) {
+        Run *phase_run = phase_runs[phase];
+        INFO("  * %-16s", phase_names[phase]);
+        for (PerfCounter counter = 0; counter < PERF_COUNTERS; counter++) {
+            if (PerfCounters_available(perf, counter)) {
+                INFO(" %s=%lu", perf_counter_names[counter],
+                    PerfReading_delta(&phase_run->perf_before[phase], &phase_run->perf_after[phase], counter));
+            }
         }
-    };
-    *oubliette = sum;
+        INFO("\n");
+    }
+    for (Phase phase = 0; phase < PHASES; phase++) {
+        PopulateCounters populate;
+        Run_populate(phase_runs[phase], phase, &populate);
+        if (populate.calls != 0) {
+            INFO("  * %-16s %9lu populate calls, %12luB populated, %12luns populating (%.1f%% of the phase)\n", 
+                phase_names[phase], populate.calls, populate.bytes, populate.time,
+                phase_runs[phase]->elapsed_time[phase] == 0 ? 0.0 
+                    : 100.0 * ((double) populate.time) / ((double) phase_runs[phase]->elapsed_time[phase]));
+        }
+    }
+    for (size_t i = 0; i < run->populate_threads_count; i++) {
+        PopulateThread *thread = &run->populate_threads[i];
+        INFO("    - %s populate thread %-6d %9lu calls, %12luB, %12luns\n", thread->backend, thread->tid,
+            thread->counters.calls, thread->counters.bytes, thread->counters.time);
+    }
+    for (size_t i = 0; i < run->mix_results_count; i++) {
+        MixResult *result = &run->mix_results[i];
+        INFO("    - object %-8s  weight %-3lu %9lu accesses, %12.0f/s, %9lu populate calls, %12luB, %12luns\n", 
+            result->benchmark, result->weight, result->accesses, result->throughput,
+            result->populate.calls, result->populate.bytes, result->populate.time);
+    }
+    if (run->objects_churned != 0) {
+        INFO("  * churned:         %12lu %s objects, %lu live per thread\n", 
+            run->objects_churned, config->churn_object, config->live);
+        INFO("  * creation:        p50 %luns, p90 %luns, p99 %luns, p99.9 %luns, max %luns\n",
+            Histogram_percentile(&run->creation_latencies, 50),
+            Histogram_percentile(&run->creation_latencies, 90),
+            Histogram_percentile(&run->creation_latencies, 99),
+            Histogram_percentile(&run->creation_latencies, 99.9),
+            run->creation_latencies.max);
+        INFO("  * cleanup:         p50 %luns, p90 %luns, p99 %luns, p99.9 %luns, max %luns\n",
+            Histogram_percentile(&run->cleanup_latencies, 50),
+            Histogram_percentile(&run->cleanup_latencies, 90),
+            Histogram_percentile(&run->cleanup_latencies, 99),
+            Histogram_percentile(&run->cleanup_latencies, 99.9),
+            run->cleanup_latencies.max);
+    }
+    if (run->lookup_results_count > 0) {
+        INFO("  * %10s %12s %12s %12s %12s %12s %12s %12s\n", "population", "create p50", 
+            "lookup p50", "lookup p99", "inside p50", "inside p99", "free p50", "free p99");
+    }
+    for (size_t i = 0; i < run->lookup_results_count; i++) {
+        LookupResult *result = &run->lookup_results[i];
+        INFO("    %10lu %10luns %10luns %10luns %10luns %10luns %10luns %10luns\n", 
+            result->population,
+            Histogram_percentile(&result->creation_latencies, 50),
+            Histogram_percentile(&result->lookup_latencies, 50),
+            Histogram_percentile(&result->lookup_latencies, 99),
+            Histogram_percentile(&result->interior_latencies, 50),
+            Histogram_percentile(&result->interior_latencies, 99),
+            Histogram_percentile(&result->cleanup_latencies, 50),
+            Histogram_percentile(&result->cleanup_latencies, 99));
+    }
+    INFO("  * execution RSS:   %12luB peak, %12luB average\n", 
+        run->memory_sampler.peak_rss, MemorySampler_average_rss(&run->memory_sampler));
+    INFO("  * VmHWM:           %12luB\n", phase_runs[SYSTEM_TEARDOWN]->memory_after[SYSTEM_TEARDOWN].hwm);
+    INFO("  * file cached:     %12luB before object creation (%s%s)\n", phase_runs[OBJECT_CREATION]->file_cached, 
+        config->cache_state, phase_runs[OBJECT_CREATION]->caches_dropped ? ", caches dropped" : "");
+    INFO("  * writes:          %12lu (%s), %lu dirty chunks of %lu elements\n", 
+        run->write_accesses, config->write_mode, run->dirty_chunks, config->min_load);
+    if (run->read_only_time != 0) {
+        INFO("  * read-only:       %12luns, writeback slowdown %.1f%%\n", 
+            run->read_only_time, Run_writeback_slowdown(run) * 100.0);
+    }
+    if (run->constrained) {
+        INFO("  * memory.max:      %12luB over %s, events: high=%lu max=%lu oom=%lu oom_kill=%lu\n", 
+            config->memory_max, run->creation_constrained ? "creation and execution" : "execution", 
+            run->cgroup.high, run->cgroup.max, run->cgroup.oom, run->cgroup.oom_kill);
+        if (!run->creation_constrained) {
+            INFO("  * memory.max:      the reused object was created in an earlier repetition and is charged to the parent cgroup, unconstrained\n");
+        }
+        INFO("  * cgroup memory:   %12luB peak, %12luB swap, %12luB swap peak\n", 
+            run->cgroup.memory_peak, run->cgroup.swap_current, run->cgroup.swap_peak);
+    }
+    INFO("  * oubliette:       %12lins\n", run->oubliette);
 }
 
-// Col
-void col_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette) {
-    int32_t *data = (int32_t *) object;    
-    int64_t sum = 0;
-    SequenceResult result;
-    while (true) {
-        result = next(config, sequence);        
-        if (result.end) {
-            break;
-        }        
-        if (result.write) {
-            data[result.current] = random_int(1000);
-        } else {
-            sum += data[result.current];
+// Mean, standard deviation, median and 95% confidence interval of the time
+// taken by each phase across the measured (non-warmup) repetitions. Shared
+// phases only contribute the repetitions in which they actually ran.
+void Run_summarize(Run *runs, size_t count, size_t first) {
+    Arguments *config = &runs[count - 1].config;
+    FILE *output_stream = NULL;
+    if (config->summary != NULL) {
+        bool exists = file_exists(config->summary);
+        output_stream = fopen(config->summary, exists ? "a" : "w");
+        if (output_stream == NULL) {
+            REPORT("Cannot open summary file \"%s\"\n", config->summary);
+        } else if (!exists) {
+            fprintf(output_stream, 
+                "benchmark,"
+                "implementation,"
+                "pattern,"
+                "min_load_count,"
+                "size,"
+                "writes,"
+                "threads,"
+                "phase,"
+                "count,"
+                "mean,"
+                "stddev,"
+                "median,"
+                "ci95_low,"
+                "ci95_high\n");
         }
-    };
-    *oubliette = sum;
+    }
+
+    INFO("Summary over %lu repetitions:\n", count - first);
+    double *samples = (double *) malloc(sizeof(double) * count);
+    for (Phase phase = 0; phase < PHASES; phase++) {
+        size_t samples_count = 0;
+        for (size_t i = first; i < count; i++) {
+            if (runs[i].ran[phase]) {
+                samples[samples_count++] = (double) runs[i].elapsed_time[phase];
+            }
+        }
+        Summary summary;
+        Summary_compute(&summary, samples, samples_count);
+        INFO("  * %-16s n=%-4lu mean=%.0fns stddev=%.0fns median=%.0fns 95%% CI=[%.0f, %.0f]ns\n",
+            phase_names[phase], summary.count, summary.mean, summary.stddev, summary.median, 
+            summary.ci_low, summary.ci_high);
+        if (output_stream != NULL) {
+            fprintf(output_stream, "%s,%s,%s,%lu,%lu,%lu,%lu,%s,%lu,%.2f,%.2f,%.2f,%.2f,%.2f\n",
+                config->benchmark,
+                config->implementation,
+                config->pattern,
+                (strcmp("ufo", config->implementation) == 0) ? config->min_load : 0,
+                runs[count - 1].sequence_length,
+                config->writes,
+                config->threads,
+                phase_names[phase],
+                summary.count,
+                summary.mean,
+                summary.stddev,
+                summary.median,
+                summary.ci_low,
+                summary.ci_high);
+        }
+    }
+    free(samples);
+    if (output_stream != NULL) {
+        fclose(output_stream);
+    }
 }
 
 // MAIN
@@ -269,33 +2666,105 @@ int main(int argc, char *argv[]) {
     /* Default values. */
     config.benchmark = "seq";
     config.implementation = "normil";
+    config.objects = "seq:1,bzip:1,mmap:1";
+    config.quantum = 64;
+    config.churn_object = "seq";
+    config.churn = 10000;
+    config.live = 1;
+    config.population_list = "10,100,1000,10000,100000";
+    config.lookups = 10000;
+    config.element = "int64";
+    config.base = 256;
+    config.fib_mode_name = "chained";
     config.size = 1 *KB;
     config.min_load = 4 *KB;
     config.high_water_mark = 2 *GB;
     config.low_water_mark = 1 *GB;
+    config.memory_max = 0; // 0 for no limit
+    config.cgroup = NULL;
+    config.mmapfile_directory = "/tmp";
     config.file = "test/test.txt.bz2";
+    config.cache_state = "none";
     config.timing = "timing.csv";
-    config.pattern = "scan";
-    config.sample_size = 0; // 0 for all
-    config.writes = 0; // 0 for none
+    config.pattern_list = "scan";
+    config.sample_size_list = "0"; // 0 for all
+    config.writes_list = "0"; // 0 for none
+    config.threads = 1;
+    config.zipf_exponent = 0.99;
+    config.hot_accesses = 90;
+    config.hot_data = 10;
+    config.stride = 16;
+    config.window = 0; // 0 for min_load
+    config.latency_sample = 1000; // 0 for none
+    config.memory_sample_interval = 10; // 0 for none
+    config.perf = true;
+    config.repeat = 1;
+    config.warmup = 0;
+    config.reuse = false;
+    config.summary = NULL;
+    config.json = NULL;
+    config.pregenerate = false;
+    config.write_mode = "interval";
+    config.burst = 1;
+    config.write_region = 10;
+    config.write_baseline = false;
+    config.instrument = true;
+    config.trace = NULL;
+    config.trace_buffer = 65536;
     config.seed = 42;
 
     // Parse arguments
     static char doc[] = "UFO performance benchmark utility.";
     static char args_doc[] = "";
     static struct argp_option options[] = {
-        {"benchmark",       'b', "BENCHMARK",      0,  "Benchmark (populate function) to run: seq, fib, mmap, col, psql, or bzip"},
-        {"implementation",  'i', "IMPL",           0,  "Implementation to run: ufo, nyc, toronto, normil, (and nyc++)"},
-        {"pattern",         'p', "FILE",           0,  "Read pattern: scan, random, reverse"},
-        {"sample-size",     'n', "FILE",           0,  "How many elements to read from vector: zero for all"},
-        {"writes",          'w', "N%%",            0,  "One write will occur once for every N%% reads, zero for read-only"},
+        {"benchmark",       'b', "BENCHMARK",      0,  "Benchmark (populate function) to run: seq, fib, mmap, col, psql, bzip, mix (several objects in one system, see --objects), churn (object creation and cleanup, see --churn), lookup (ufo address lookups, see --populations), tseq (seq with elements of any type, see --element), rep, rep-each, rep-len, or outer (repetitions and outer products of a seq, see --base)"},
+        {"implementation",  'i', "IMPL",           0,  "Implementation to run: ufo, nyc, toronto, normil, mmapfile, (and nyc++)"},
+        {"objects",         'o', "B:W,...",        0,  "Objects of the mix benchmark as benchmark:weight pairs, accessed in proportion to their weights, default: seq:1,bzip:1,mmap:1"},
+        {"quantum",         'q', "N",              0,  "Consecutive accesses to one object of the mix benchmark before picking the next one, default: 64"},
+        {"churn",           'c', "N",              0,  "Objects each thread creates and frees in the churn benchmark, default: 10000"},
+        {"churn-object",    'C', "BENCHMARK",      0,  "Benchmark whose objects the churn benchmark creates, default: seq"},
+        {"live",            'K', "N",              0,  "Objects each thread keeps alive at once in the churn benchmark, default: 1"},
+        {"populations",     'y', "N,...",          0,  "Increasing numbers of live objects at which the lookup benchmark measures, default: 10,100,1000,10000,100000"},
+        {"lookups",         'Q', "N",              0,  "Lookups of each kind, and frees, at every population of the lookup benchmark, default: 10000"},
+        {"element",         'U', "TYPE",           0,  "Element type of the tseq benchmark: int8, uint8, int16, uint16, int32, uint32, int64, uint64, float, or double, default: int64"},
+        {"base",            'N', "N",              0,  "Length of the vector repeated by the rep, rep-each, and rep-len benchmarks, and of x in outer(x, y) for the outer benchmark, default: 256"},
+        {"fib-mode",        'F', "MODE",           0,  "How the fib benchmark populates a chunk: chained (from the elements before it, populating every earlier chunk first) or independent (by fast doubling, so chunks are populated on their own), default: chained"},
+        {"pattern",         'p', "P,...",          0,  "Read pattern: scan, random, reverse, stride, chunk-random, zipf, hotset"},
+        {"sample-size",     'n', "N,...",          0,  "How many elements to read from vector: zero for all"},
+        {"writes",          'w', "N%%,...",        0,  "One write will occur once for every N%% reads, zero for read-only"},
+        {"write-mode",      'X', "MODE",           0,  "Which accesses write: interval (one in every --writes), only (all), update (read-modify-write one in every --writes), burst (--burst consecutive writes in every --writes), hot (like interval, confined to --write-region), default: interval"},
+        {"burst",           'B', "M",              0,  "Consecutive writes in every --writes accesses in the burst write mode, default: 1"},
+        {"write-region",    'D', "X%%",            0,  "Percentage of data, at the front of the object, that the hot write mode writes to, default: 10"},
+        {"write-baseline",  'V', "1|0",            0,  "Also time a read-only execution of the same sequence on a fresh object to compute the writeback slowdown, default: 0"},
         {"size",            's', "#B",             0,  "Vector size (applicable for fib and seq)"},        
         {"file",            'f', "FILE",           0,  "Input file (applicable for bzip)"},
+        {"cache-state",     'H', "STATE",          0,  "Page cache state of --file before each object creation: cold (evicted, and all caches dropped if root), warm (read in full), or none (left alone), default: none"},
         {"min-load",        'm', "#B",             0,  "Min load count for ufo"},
         {"high-water-mark", 'h', "#B",             0,  "High water mark for ufo GC"},
         {"low-water-mark",  'l', "#B",             0,  "Low water mark for ufo GC"},
+        {"memory-max",      'x', "#B",             0,  "Run object creation and execution in a cgroup v2 with this memory.max, zero for no limit, default: 0"},
+        {"cgroup",          'g', "PATH",           0,  "Parent cgroup of the --memory-max cgroup, default: the benchmark's own cgroup"},
+        {"mmapfile-dir",    'A', "DIR",            0,  "Directory of the temporary files that back mmapfile objects, default: /tmp"},
         {"timing",          't', "FILE",           0,  "Path of CSV output file for time measurements"},        
+        {"json",            'j', "FILE",           0,  "Path of NDJSON output file for configuration, environment, and measurements"},
         {"seed",            'S', "N",              0,  "Random seed, default: 42"},
+        {"pregenerate",     'G', "1|0",            0,  "Generate the whole index sequence before execution starts (9B per access), default: 0"},
+        {"threads",         'T', "N",              0,  "Number of threads that split the index sequence between them, default: 1"},
+        {"stride",          'k', "K",              0,  "Step between consecutive accesses in the stride pattern, default: 16"},
+        {"window",          'W', "N",              0,  "Number of elements scanned from each chunk in the chunk-random pattern: zero for min-load"},
+        {"latency-sample",  'L', "N",              0,  "Time one in every N accesses for the latency histogram, zero for none, default: 1000"},
+        {"memory-sample",   'M', "MS",             0,  "Milliseconds between RSS samples during execution, zero for none, default: 10"},
+        {"perf",            'P', "1|0",            0,  "Collect perf_event counters for each phase, default: 1"},
+        {"instrument",      'I', "1|0",            0,  "Count calls, bytes, and time spent in populate functions, default: 1"},
+        {"trace",           'e', "FILE",           0,  "Write a Chrome trace of populate calls and phases to FILE at exit"},
+        {"trace-buffer",    'E', "N",              0,  "Trace events kept per thread, older ones are dropped, default: 65536"},
+        {"repeat",          'r', "N",              0,  "Measured repetitions of object creation, execution and cleanup, default: 1"},
+        {"warmup",          'u', "N",              0,  "Unmeasured repetitions to run before the measured ones, default: 0"},
+        {"reuse",           'R', "1|0",            0,  "Reuse one object across all repetitions and sweep combinations instead of recreating it, only with a single write ratio, default: 0"},
+        {"summary",         'O', "FILE",           0,  "Path of CSV output file for per-phase statistics across repetitions"},
+        {"zipf-exponent",   'z', "S",              0,  "Exponent of the zipf pattern, default: 0.99"},
+        {"hot-accesses",    'a', "X%%",            0,  "Percentage of accesses that go to the hot set in the hotset pattern, default: 90"},
+        {"hot-data",        'd', "Y%%",            0,  "Percentage of data that forms the hot set in the hotset pattern, default: 10"},
         { 0 }
     };
     static struct argp argp = { options, parse_opt, args_doc, doc };   
@@ -305,19 +2774,127 @@ int main(int argc, char *argv[]) {
     INFO("Benchmark configuration:\n");
     INFO("  * benchmark:       %s\n",  config.benchmark      );
     INFO("  * implementation:  %s\n",  config.implementation );
-    INFO("  * pattern:         %s\n",  config.pattern        );
+    if (strcmp(config.benchmark, "mix") == 0) {
+        INFO("  * objects:         %s\n",  config.objects     );
+        INFO("  * quantum:         %lu\n", config.quantum     );
+    }
+    if (strcmp(config.benchmark, "churn") == 0) {
+        INFO("  * churn_object:    %s\n",  config.churn_object);
+        INFO("  * churn:           %lu\n", config.churn       );
+        INFO("  * live:            %lu\n", config.live        );
+    }
+    if (strcmp(config.benchmark, "lookup") == 0) {
+        INFO("  * populations:     %s\n",  config.population_list);
+        INFO("  * lookups:         %lu\n", config.lookups     );
+    }
+    if (strcmp(config.benchmark, "tseq") == 0) {
+        INFO("  * element:         %s\n",  config.element     );
+    }
+    if (strcmp(config.benchmark, "fib") == 0) {
+        INFO("  * fib_mode:        %s\n",  config.fib_mode_name);
+    }
+    if (rep_benchmark_known(config.benchmark)) {
+        INFO("  * base:            %lu\n", config.base        );
+    }
+    INFO("  * pattern:         %s\n",  config.pattern_list   );
     INFO("  * size:            %lu\n", config.size           );
     INFO("  * min_load:        %lu\n", config.min_load       );
     INFO("  * high_water_mark: %lu\n", config.high_water_mark);
     INFO("  * low_water_mark:  %lu\n", config.low_water_mark );
+    INFO("  * memory_max:      %lu\n", config.memory_max     );
+    INFO("  * cgroup:          %s\n",  config.cgroup == NULL ? "own" : config.cgroup);
+    if (strcmp(config.implementation, "mmapfile") == 0) {
+        INFO("  * mmapfile_dir:    %s\n",  config.mmapfile_directory);
+    }
     INFO("  * file:            %s\n",  config.file           );
+    INFO("  * cache_state:     %s\n",  config.cache_state    );
     INFO("  * timing:          %s\n",  config.timing         );
-    INFO("  * writes:          %lu\n", config.writes         );
-    INFO("  * sample_size:     %lu\n", config.sample_size    );
+    INFO("  * json:            %s\n",  config.json == NULL ? "none" : config.json);
+    INFO("  * writes:          %s\n",  config.writes_list    );
+    INFO("  * write_mode:      %s\n",  config.write_mode     );
+    INFO("  * burst:           %lu\n", config.burst          );
+    INFO("  * write_region:    %.1f%%\n", config.write_region );
+    INFO("  * write_baseline:  %s\n",  config.write_baseline ? "yes" : "no");
+    INFO("  * sample_size:     %s\n",  config.sample_size_list);
     INFO("  * seed:            %u\n",  config.seed           );
+    INFO("  * pregenerate:     %s\n",  config.pregenerate ? "yes" : "no");
+    INFO("  * threads:         %lu\n", config.threads        );
+    INFO("  * stride:          %lu\n", config.stride         );
+    INFO("  * window:          %lu\n", config.window         );
+    INFO("  * latency_sample:  %lu\n", config.latency_sample );
+    INFO("  * memory_sample:   %lums\n", config.memory_sample_interval);
+    INFO("  * perf:            %s\n",  config.perf ? "yes" : "no");
+    INFO("  * instrument:      %s\n",  config.instrument ? "yes" : "no");
+    INFO("  * trace:           %s\n",  config.trace == NULL ? "none" : config.trace);
+    INFO("  * repeat:          %lu\n", config.repeat         );
+    INFO("  * warmup:          %lu\n", config.warmup         );
+    INFO("  * reuse:           %s\n",  config.reuse ? "yes" : "no");
+    INFO("  * zipf_exponent:   %.3f\n", config.zipf_exponent  );
+    INFO("  * hot_accesses:    %.1f%%\n", config.hot_accesses );
+    INFO("  * hot_data:        %.1f%%\n", config.hot_data     );
+
+    if (config.threads == 0) {
+        REPORT("Thread count must be at least 1\n");
+        return 6;
+    }
+    if (config.repeat == 0) {
+        REPORT("Repeat count must be at least 1\n");
+        return 6;
+    }
+    if (!write_mode_known(config.write_mode)) {
+        REPORT("Unknown write mode \"%s\"\n", config.write_mode);
+        return 6;
+    }
+    if (config.write_region <= 0 || config.write_region > 100) {
+        REPORT("Write region percentage must be above 0 and at most 100\n");
+        return 6;
+    }
+    SeqType element;
+    if (!seq_type_parse(config.element, &element)) {
+        REPORT("Unknown element type \"%s\"\n", config.element);
+        return 6;
+    }
+    if (!fib_mode_parse(config.fib_mode_name, &config.fib_mode)) {
+        REPORT("Unknown fib mode \"%s\"\n", config.fib_mode_name);
+        return 6;
+    }
+    if (rep_benchmark_known(config.benchmark) && (config.base == 0 || config.base > config.size)) {
+        REPORT("Base length must be between 1 and the size\n");
+        return 6;
+    }
+    if (rep_benchmark_known(config.benchmark) && strcmp(config.benchmark, "rep-len") != 0 
+        && config.size % config.base != 0) {
+        REPORT("Size must be a multiple of the base length for the %s benchmark\n", config.benchmark);
+        return 6;
+    }
+    if (strcmp(config.cache_state, "cold") != 0 && strcmp(config.cache_state, "warm") != 0 
+        && strcmp(config.cache_state, "none") != 0) {
+        REPORT("Unknown cache state \"%s\"\n", config.cache_state);
+        return 6;
+    }
+    if (config.quantum == 0 || config.quantum > SEQUENCE_BATCH_SIZE) {
+        REPORT("Quantum must be between 1 and %d\n", SEQUENCE_BATCH_SIZE);
+        return 6;
+    }
+    if (config.churn == 0 || config.live == 0) {
+        REPORT("Churn and live object counts must be at least 1\n");
+        return 6;
+    }
+    if (config.stride == 0) {
+        REPORT("Stride must be at least 1\n");
+        return 6;
+    }
+    if (config.zipf_exponent <= 0) {
+        REPORT("Zipf exponent must be positive\n");
+        return 6;
+    }
+    if (config.hot_accesses < 0 || config.hot_accesses > 100 || config.hot_data < 0 || config.hot_data > 100) {
+        REPORT("Hot set percentages must be between 0 and 100\n");
+        return 6;
+    }
 
     // Random seed
-    srand(config.seed);
+    random_seed(config.seed);
 
     // Setup and teardown;
     INFO("System configuration\n");
@@ -343,6 +2920,10 @@ int main(int argc, char *argv[]) {
         system_setup = &normil_setup;
         system_teardown = &normil_teardown;
     }
+    if (strcmp(config.implementation, "mmapfile") == 0) {
+        system_setup = &mmapfile_setup;
+        system_teardown = &mmapfile_teardown;
+    }
     if (system_setup == NULL || system_teardown == NULL) {
         REPORT("Unknown implementation \"%s\"\n", config.implementation);
         return 4;
@@ -350,307 +2931,305 @@ int main(int argc, char *argv[]) {
 
     // Object creation, execution and teardown.
     printf("Object configuration\n");
-    object_creation_t object_creation = NULL;
-    execution_t execution = NULL;
-    object_cleanup_t object_cleanup = NULL;
-    max_length_t max_length = NULL;
-    if ((strcmp(config.benchmark, "fib") == 0) && (strcmp(config.implementation, "ufo") == 0)) {
-        object_creation = ufo_fib_creation;
-        object_cleanup = ufo_fib_cleanup;
-        execution = fib_execution;        
-        max_length = fib_max_length;
-    }
-    if ((strcmp(config.benchmark, "fib") == 0) && (strcmp(config.implementation, "nyc") == 0)) {
-        object_creation = ny_fib_creation;
-        object_cleanup = ny_fib_cleanup;
-        execution = ny_fib_execution;        
-        max_length = ny_max_length;
-    }
-    if ((strcmp(config.benchmark, "fib") == 0) && (strcmp(config.implementation, "toronto") == 0)) {
-        object_creation = toronto_fib_creation;
-        object_cleanup = toronto_fib_cleanup;
-        execution = toronto_fib_execution;        
-        max_length = toronto_max_length;
-    }
-    if ((strcmp(config.benchmark, "fib") == 0) && (strcmp(config.implementation, "nyc++") == 0)) {
-        object_creation = nycpp_fib_creation;
-        object_cleanup = nycpp_fib_cleanup;
-        execution = nycpp_fib_execution;        
-        max_length = fib_max_length;
-    }
-    if ((strcmp(config.benchmark, "fib") == 0) && (strcmp(config.implementation, "normil") == 0)) {
-        object_creation = normil_fib_creation;
-        object_cleanup = normil_fib_cleanup;
-        execution = fib_execution;        
-        max_length = fib_max_length;
-    }
-    if ((strcmp(config.benchmark, "mmap") == 0) && (strcmp(config.implementation, "ufo") == 0)) {
-        object_creation = ufo_mmap_creation;
-        object_cleanup = ufo_mmap_cleanup;
-        execution = mmap_execution;        
-        max_length = mmap_max_length;
-    }
-    if ((strcmp(config.benchmark, "mmap") == 0) && (strcmp(config.implementation, "nyc") == 0)) {
-        object_creation = ny_mmap_creation;
-        object_cleanup = ny_mmap_cleanup;
-        execution = ny_mmap_execution;        
-        max_length = ny_max_length;
-    }
-    if ((strcmp(config.benchmark, "mmap") == 0) && (strcmp(config.implementation, "toronto") == 0)) {
-        object_creation = toronto_mmap_creation;
-        object_cleanup = toronto_mmap_cleanup;
-        execution = toronto_mmap_execution;        
-        max_length = toronto_max_length;
-    }
-    if ((strcmp(config.benchmark, "mmap") == 0) && (strcmp(config.implementation, "nyc++") == 0)) {
-        object_creation = nycpp_mmap_creation;
-        object_cleanup = nycpp_mmap_cleanup;
-        execution = nycpp_mmap_execution;        
-        max_length = mmap_max_length;
-    }
-    if ((strcmp(config.benchmark, "mmap") == 0) && (strcmp(config.implementation, "normil") == 0)) {
-        object_creation = normil_mmap_creation;
-        object_cleanup = normil_mmap_cleanup;
-        execution = mmap_execution;        
-        max_length = mmap_max_length;
-    }
-    if ((strcmp(config.benchmark, "bzip") == 0) && (strcmp(config.implementation, "ufo") == 0)) {
-        object_creation = ufo_bzip_creation;
-        object_cleanup = ufo_bzip_cleanup;
-        execution = bzip_execution;        
-        max_length = bzip_max_length;
-    }
-    if ((strcmp(config.benchmark, "bzip") == 0) && (strcmp(config.implementation, "nyc") == 0)) {
-        object_creation = ny_bzip_creation;
-        object_cleanup = ny_bzip_cleanup;
-        execution = ny_bzip_execution;        
-        max_length = ny_max_length;
-    }
-    if ((strcmp(config.benchmark, "bzip") == 0) && (strcmp(config.implementation, "toronto") == 0)) {
-        object_creation = toronto_bzip_creation;
-        object_cleanup = toronto_bzip_cleanup;
-        execution = toronto_bzip_execution;        
-        max_length = toronto_max_length;
-    }
-    if ((strcmp(config.benchmark, "bzip") == 0) && (strcmp(config.implementation, "nyc++") == 0)) {
-        object_creation = nycpp_bzip_creation;
-        object_cleanup = nycpp_bzip_cleanup;
-        execution = nycpp_bzip_execution;        
-        max_length = bzip_max_length;
-    }
-    if ((strcmp(config.benchmark, "bzip") == 0) && (strcmp(config.implementation, "normil") == 0)) {
-        object_creation = normil_bzip_creation;
-        object_cleanup = normil_bzip_cleanup;
-        execution = bzip_execution;        
-        max_length = bzip_max_length;
-    }
-    if ((strcmp(config.benchmark, "seq") == 0) && (strcmp(config.implementation, "ufo") == 0)) {
-        object_creation = ufo_seq_creation;
-        object_cleanup = ufo_seq_cleanup;
-        execution = seq_execution;
-        max_length = seq_max_length;
-    }
-    if ((strcmp(config.benchmark, "seq") == 0) && (strcmp(config.implementation, "nyc") == 0)) {
-        object_creation = ny_seq_creation;
-        object_cleanup = ny_seq_cleanup;
-        execution = ny_seq_execution;        
-        max_length = ny_max_length;
-    }
-    if ((strcmp(config.benchmark, "seq") == 0) && (strcmp(config.implementation, "toronto") == 0)) {
-        object_creation = toronto_seq_creation;
-        object_cleanup = toronto_seq_cleanup;
-        execution = toronto_seq_execution;        
-        max_length = toronto_max_length;
-    }
-    if ((strcmp(config.benchmark, "seq") == 0) && (strcmp(config.implementation, "nyc++") == 0)) {
-        object_creation = nycpp_seq_creation;
-        object_cleanup = nycpp_seq_cleanup;
-        execution = nycpp_seq_execution;        
-        max_length = seq_max_length;
-    }
-    if ((strcmp(config.benchmark, "seq") == 0) && (strcmp(config.implementation, "normil") == 0)) {
-        object_creation = normil_seq_creation;
-        object_cleanup = normil_seq_cleanup;
-        execution = seq_execution;        
-        max_length = seq_max_length;
-    }
-    if ((strcmp(config.benchmark, "psql") == 0) && (strcmp(config.implementation, "ufo") == 0)) {
-        object_creation = ufo_psql_creation;
-        object_cleanup = ufo_psql_cleanup;
-        execution = psql_execution;
-        max_length = psql_max_length;
-    }
-    if ((strcmp(config.benchmark, "psql") == 0) && (strcmp(config.implementation, "nyc") == 0)) {
-        object_creation = ny_psql_creation;
-        object_cleanup = ny_psql_cleanup;
-        execution = ny_psql_execution;        
-        max_length = ny_max_length;
-    }
-    if ((strcmp(config.benchmark, "psql") == 0) && (strcmp(config.implementation, "toronto") == 0)) {
-        object_creation = toronto_psql_creation;
-        object_cleanup = toronto_psql_cleanup;
-        execution = toronto_psql_execution;        
-        max_length = toronto_max_length;
-    }
-    if ((strcmp(config.benchmark, "psql") == 0) && (strcmp(config.implementation, "nyc++") == 0)) {
-        object_creation = nycpp_psql_creation;
-        object_cleanup = nycpp_psql_cleanup;
-        execution = nycpp_psql_execution;        
-        max_length = psql_max_length;
-    }
-    if ((strcmp(config.benchmark, "psql") == 0) && (strcmp(config.implementation, "normil") == 0)) {
-        object_creation = normil_psql_creation;
-        object_cleanup = normil_psql_cleanup;
-        execution = psql_execution;        
-        max_length = psql_max_length;
-    }
-        if ((strcmp(config.benchmark, "col") == 0) && (strcmp(config.implementation, "ufo") == 0)) {
-        object_creation = ufo_col_creation;
-        object_cleanup = ufo_col_cleanup;
-        execution = col_execution;
-        max_length = col_max_length;
-    }
-    if ((strcmp(config.benchmark, "col") == 0) && (strcmp(config.implementation, "nyc") == 0)) {
-        object_creation = ny_col_creation;
-        object_cleanup = ny_col_cleanup;
-        execution = ny_col_execution;        
-        max_length = ny_max_length;
-    }
-    if ((strcmp(config.benchmark, "col") == 0) && (strcmp(config.implementation, "toronto") == 0)) {
-        object_creation = toronto_col_creation;
-        object_cleanup = toronto_col_cleanup;
-        execution = toronto_col_execution;        
-        max_length = toronto_max_length;
-    }
-    if ((strcmp(config.benchmark, "col") == 0) && (strcmp(config.implementation, "nyc++") == 0)) {
-        object_creation = nycpp_col_creation;
-        object_cleanup = nycpp_col_cleanup;
-        execution = nycpp_col_execution;        
-        max_length = col_max_length;
-    }
-    if ((strcmp(config.benchmark, "col") == 0) && (strcmp(config.implementation, "normil") == 0)) {
-        object_creation = normil_col_creation;
-        object_cleanup = normil_col_cleanup;
-        execution = col_execution;        
-        max_length = col_max_length;
-    }
-    if (object_creation == NULL || object_cleanup == NULL) {
+    Backend backend;
+    Mix mix;
+    bool mixed = strcmp(config.benchmark, "mix") == 0;
+    bool churned = strcmp(config.benchmark, "churn") == 0;
+    bool lookup = strcmp(config.benchmark, "lookup") == 0;
+    size_t *populations = NULL;
+    size_t populations_count = 0;
+    memset(&backend, 0, sizeof(Backend));
+    memset(&mix, 0, sizeof(Mix));
+    if (mixed) {
+        int result = Mix_parse(&mix, config.objects, config.implementation);
+        if (result != 0) {
+            return result;
+        }
+        if (config.threads != 1) {
+            REPORT("The mix benchmark runs on one thread\n");
+            return 6;
+        }
+        if (config.write_baseline) {
+            REPORT("The mix benchmark has no read-only baseline\n");
+            return 6;
+        }
+    } else if (churned) {
+        if (!Backend_select(config.churn_object, config.implementation, &backend)) {
+            REPORT("Unknown benchmark/implementation combination \"%s\"/\"%s\"\n", 
+            config.churn_object, config.implementation);
+            return 4;
+        }
+        if (config.write_baseline) {
+            REPORT("The churn benchmark has no read-only baseline\n");
+            return 6;
+        }
+    } else if (lookup) {
+        if (strcmp(config.implementation, "ufo") != 0) {
+            REPORT("The lookup benchmark only runs on ufo\n");
+            return 4;
+        }
+        if (config.threads != 1 || config.write_baseline) {
+            REPORT("The lookup benchmark runs on one thread and has no read-only baseline\n");
+            return 6;
+        }
+        char **items;
+        char *population_list = strdup(config.population_list);
+        populations_count = split_list(population_list, &items);
+        populations = (size_t *) malloc(sizeof(size_t) * populations_count);
+        for (size_t i = 0; i < populations_count; i++) {
+            populations[i] = (size_t) atol(items[i]);
+            if (populations[i] == 0 || (i > 0 && populations[i] <= populations[i - 1])) {
+                REPORT("Populations must be increasing and at least 1\n");
+                return 6;
+            }
+        }
+        free(items);
+        free(population_list);
+        if (populations_count == 0 || config.lookups == 0 || config.size == 0) {
+            REPORT("The lookup benchmark needs at least one population, one lookup, and a size\n");
+            return 6;
+        }
+    } else if (!Backend_select(config.benchmark, config.implementation, &backend)) {
         REPORT("Unknown benchmark/implementation combination \"%s\"/\"%s\"\n", 
         config.benchmark, config.implementation);
         return 4;
     }
+    object_creation_t object_creation = backend.object_creation;
+    execution_t execution = backend.execution;
+    object_cleanup_t object_cleanup = backend.object_cleanup;
+    max_length_t max_length = backend.max_length;
+
+    // Populate functions are only wrapped for objects created after this.
+    if (config.trace != NULL) {
+        trace_start(config.trace, config.trace_buffer);
+        trace_thread_name("main");
+    }
+    // The mix benchmark counts populate calls per object.
+    instrument_enable(config.instrument || config.trace != NULL || mixed);
+
+    // Perf counters are opened before system setup, so that they are
+    // inherited by any threads the system starts.
+    PerfCounters perf;
+    PerfCounters_init(&perf);
+    if (config.perf) {
+        PerfCounters_open(&perf);
+    }
+
+    // Sweep over every combination of the listed patterns, sample sizes
+    // and write ratios. Warmup repetitions run first in each combination
+    // and are not recorded.
+    char **patterns, **sample_sizes, **writes;
+    size_t patterns_count = split_list(config.pattern_list, &patterns);
+    size_t sample_sizes_count = split_list(config.sample_size_list, &sample_sizes);
+    size_t writes_count = split_list(config.writes_list, &writes);
+    size_t combinations_count = patterns_count * sample_sizes_count * writes_count;
+    if (combinations_count == 0) {
+        REPORT("Pattern, sample size, and write lists must not be empty\n");
+        return 6;
+    }
+
+    // A reused object is created once, read-only or not, and every write
+    // ratio after the first would run on an object that the ones before
+    // already wrote to.
+    if (config.reuse && writes_count > 1) {
+        REPORT("Cannot reuse one object across several write ratios\n");
+        return 6;
+    }
+
+    for (size_t p = 0; p < patterns_count; p++) {
+        if (!pattern_known(patterns[p])) {
+            REPORT("Unknown sequence pattern \"%s\"\n", patterns[p]);
+            return 5;
+        }
+    }
+
+    size_t repetitions_count = config.warmup + config.repeat;
+    size_t runs_count = combinations_count * repetitions_count;
+    Run *runs = (Run *) calloc(runs_count, sizeof(Run));
 
     // System setup
     INFO("System setup\n");
-    uint64_t system_setup_start_time = current_time_in_ns();
+    Run_begin(&runs[0], &perf, SYSTEM_SETUP);
     AnySystem system = system_setup(&config);
-    uint64_t system_setup_elapsed_time = current_time_in_ns() - system_setup_start_time;
+    Run_end(&runs[0], &perf, SYSTEM_SETUP);
 
-    // Object creation
-    INFO("Object creation\n");
-    uint64_t object_creation_start_time = current_time_in_ns();
-    AnyObject object = object_creation(&config, system);
-    uint64_t object_creation_elapsed_time = current_time_in_ns() - object_creation_start_time;
+    // With --memory-max, every repetition runs in a cgroup of its own, until
+    // one cannot be set up.
+    bool cgroup_usable = config.memory_max != 0;
 
-    // Detour: sequence selection    
-    INFO("Index sequence configuration\n");
-    AnySequence sequence = NULL;
-    sequence_t next = NULL;
-    size_t max_sequence_length = max_length(&config, system, object);
-    size_t sequence_length = 
-        (config.sample_size != 0 && max_sequence_length > config.sample_size) 
-        ? config.sample_size : max_sequence_length;
-    if (strcmp(config.pattern, "scan") == 0) {
-        ScanSequence *scan_sequence = malloc(sizeof(ScanSequence));
-        scan_sequence->current = 0;
-        scan_sequence->length = sequence_length;
-        scan_sequence->since_last_write = config.writes;
-        sequence = (AnySequence) scan_sequence;
-        next = &ScanSequence_next;
-    }
-    if (strcmp(config.pattern, "reverse") == 0) {
-        ReverseSequence *reverse_sequence = malloc(sizeof(ReverseSequence));
-        reverse_sequence->current = sequence_length + 1;
-        reverse_sequence->since_last_write = config.writes;
-        sequence = (AnySequence) reverse_sequence;
-        next = &ReverseSequence_next;
+    // With --reuse, one object serves every repetition of every combination.
+    AnyObject object = NULL;
+    bool object_exists = false;
+    size_t r = 0;
+    for (size_t p = 0; p < patterns_count; p++) {
+    for (size_t n = 0; n < sample_sizes_count; n++) {
+    for (size_t w = 0; w < writes_count; w++) {
+        Arguments combination = config;
+        combination.pattern = patterns[p];
+        combination.sample_size = (size_t) atol(sample_sizes[n]);
+        combination.writes = (size_t) atol(writes[w]);
+        if (combinations_count > 1) {
+            INFO("Combination: pattern=%s sample_size=%lu writes=%lu\n", 
+                combination.pattern, combination.sample_size, combination.writes);
+        }
+
+        for (size_t i = 0; i < repetitions_count; i++, r++) {
+            Run *run = &runs[r];
+            run->config = combination;
+            run->repetition = i < config.warmup ? 0 : i - config.warmup;
+            INFO("%s %lu\n", i < config.warmup ? "Warmup" : "Repetition", run->repetition);
+
+            // Read-only baseline of the same index sequence, on an object of
+            // its own, so that the writes can be charged for the slowdown.
+            bool has_writes = config_has_writes(&combination);
+            if (config.write_baseline && has_writes) {
+                INFO("Read-only baseline\n");
+                Run baseline;
+                memset(&baseline, 0, sizeof(Run));
+                baseline.config = combination;
+                baseline.config.writes = 0;
+                baseline.config.write_mode = "interval";
+                Run_prepare_cache(&baseline, &baseline.config);
+                AnyObject baseline_object = object_creation(&baseline.config, system);
+                int result = Run_execute(&baseline, &perf, &baseline.config, system, baseline_object, execution, max_length);
+                if (result != 0) {
+                    return result;
+                }
+                object_cleanup(&baseline.config, system, baseline_object);
+                run->read_only_time = baseline.elapsed_time[EXECUTION];
+                free(baseline.thread_execution_times);
+                free(baseline.populate_threads);
+            }
+
+            Cgroup cgroup;
+            memset(&cgroup, 0, sizeof(Cgroup));
+            if (cgroup_usable) {
+                cgroup_usable = Cgroup_create(&cgroup, config.cgroup, config.memory_max);
+            }
+
+            // The churn and lookup benchmarks create and free their own
+            // objects.
+            if (churned || lookup) {
+                run->constrained = Cgroup_enter(&cgroup);
+                run->creation_constrained = run->constrained;
+                int result = churned 
+                    ? Run_churn(run, &perf, &run->config, system, &backend)
+                    : Run_lookup(run, &perf, &run->config, system, populations, populations_count);
+                Run_constrained(run, &cgroup);
+                if (result != 0) {
+                    return result;
+                }
+                continue;
+            }
+
+            // The page cache is prepared outside the cgroup, so that a warm
+            // input file is not charged to memory.max. The cgroup is entered
+            // before object creation: charges stay where they were made, so
+            // the data normil and mmapfile materialize up front would
+            // otherwise escape memory.max. A reused object stays charged to
+            // the first repetition's cgroup, and from then on to its parent.
+            bool creating = !object_exists;
+            if (creating) {
+                Run_prepare_cache(run, &run->config);
+            }
+            run->constrained = Cgroup_enter(&cgroup);
+
+            // Object creation
+            if (creating) {
+                INFO("Object creation\n");
+                run->creation_constrained = run->constrained;
+                Run_begin(run, &perf, OBJECT_CREATION);
+                if (mixed) {
+                    Mix_create(&mix, &run->config, system);
+                } else {
+                    object = object_creation(&run->config, system);
+                }
+                Run_end(run, &perf, OBJECT_CREATION);
+                object_exists = true;
+            }
+
+            // Execution
+            int result = mixed 
+                ? Run_execute_mix(run, &perf, &run->config, system, &mix)
+                : Run_execute(run, &perf, &run->config, system, object, execution, max_length);
+            Run_constrained(run, &cgroup);
+            if (result != 0) {
+                return result;
+            }
+
+            // Object cleanup
+            if (!config.reuse || r == runs_count - 1) {
+                INFO("Object cleanup\n");
+                Run_begin(run, &perf, OBJECT_CLEANUP);
+                if (mixed) {
+                    Mix_cleanup(&mix, &run->config, system);
+                } else {
+                    object_cleanup(&run->config, system, object);
+                }
+                Run_end(run, &perf, OBJECT_CLEANUP);
+                object_exists = false;
+            }
+        }
     }
-    if (strcmp(config.pattern, "random") == 0) {
-        RandomSequence *random_sequence = malloc(sizeof(RandomSequence));
-        random_sequence->generated = 0;
-        random_sequence->length = sequence_length;
-        random_sequence->max_length = max_sequence_length;
-        random_sequence->since_last_write = config.writes;
-        sequence = (AnySequence) random_sequence;
-        next = &RandomSequence_next;
     }
-    if (sequence == NULL) {
-        INFO("Unknown sequence pattern \"%s\"\n", config.pattern);
-        return 5;
     }
-
-    // Execution
-    INFO("Execution\n");
-    int64_t oubliette = 0;
-    uint64_t execution_start_time = current_time_in_ns();
-    execution(&config, system, object, sequence, next, &oubliette);
-    uint64_t execution_elapsed_time = current_time_in_ns() - execution_start_time;
-
-    // Object cleanup
-    INFO("Object cleanup\n");
-    uint64_t object_cleanup_start_time = current_time_in_ns();
-    object_cleanup(&config, system, object);
-    uint64_t object_cleanup_elapsed_time = current_time_in_ns() - object_cleanup_start_time;
     
     // System teardown
     INFO("System teardown\n");
-    uint64_t system_teardown_start_time = current_time_in_ns();
+    Run_begin(&runs[runs_count - 1], &perf, SYSTEM_TEARDOWN);
     system_teardown(&config, system);
-    uint64_t system_teardown_elapsed_time = current_time_in_ns() - system_teardown_start_time;
+    Run_end(&runs[runs_count - 1], &perf, SYSTEM_TEARDOWN);
 
-    // Output (TODO: to CSV)
+    // Output: one row per measured repetition of each combination.
     FILE *output_stream;
     if (!file_exists(config.timing)) {
         output_stream = fopen(config.timing, "w");
-        fprintf(output_stream, 
-               "benchmark,"
-               "implementation,"
-               "pattern,"
-               "min_load_count,"
-               "size,"
-               "writes,"
-               "system_setup_time,"
-               "object_creation_time,"
-               "execution_time,"
-               "object_cleanup_time,"
-               "system_teardown_time\n");
+        Run_write_header(output_stream);
     } else {
         output_stream = fopen(config.timing, "a");
     }
+    for (r = 0; r < runs_count; r++) {
+        if (r % repetitions_count >= config.warmup) {
+            Run_write(output_stream, &perf, runs, runs_count, r);
+        }
+    }
+    fclose(output_stream);
 
-    fprintf(output_stream,
-        "%s,%s,%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
-        config.benchmark,
-        config.implementation,
-        config.pattern,
-        (strcmp("ufo", config.implementation) == 0) ? config.min_load : 0, // Only if it matters
-        sequence_length,
-        config.writes,
-        system_setup_elapsed_time,
-        object_creation_elapsed_time,
-        execution_elapsed_time,
-        object_cleanup_elapsed_time,
-        system_teardown_elapsed_time);
-
-    INFO("Results:\n");
-    INFO("  * system_setup:    %12luns\n", system_setup_elapsed_time);
-    INFO("  * object_creation: %12luns\n", object_creation_elapsed_time);
-    INFO("  * execution:       %12luns\n", execution_elapsed_time);
-    INFO("  * object_cleanup:  %12luns\n", object_cleanup_elapsed_time);
-    INFO("  * object_teardown: %12luns\n", system_teardown_elapsed_time);
-    INFO("  * oubliette:       %12lins\n", oubliette);
+    if (config.json != NULL) {
+        Environment environment;
+        Environment_capture(&environment);
+        FILE *json_stream = fopen(config.json, "a");
+        if (json_stream == NULL) {
+            REPORT("Cannot open JSON output file \"%s\"\n", config.json);
+        } else {
+            for (r = 0; r < runs_count; r++) {
+                if (r % repetitions_count >= config.warmup) {
+                    Run_write_json(json_stream, &environment, &perf, runs, runs_count, r);
+                }
+            }
+            fclose(json_stream);
+        }
+    }
 
-    // Various cleanup
-    free(sequence);
+    for (size_t c = 0; c < combinations_count; c++) {
+        Run_report(&perf, runs, runs_count, (c + 1) * repetitions_count - 1);
+        if (config.repeat > 1) {
+            Run_summarize(runs + c * repetitions_count, repetitions_count, config.warmup);
+        }
+    }
 
-}
\ No newline at end of file
+    // Various cleanup
+    for (r = 0; r < runs_count; r++) {
+        free(runs[r].thread_execution_times);
+        free(runs[r].populate_threads);
+        free(runs[r].mix_results);
+        free(runs[r].lookup_results);
+    }
+    free(populations);
+    free(runs);
+    Mix_free(&mix);
+    free(patterns);
+    free(sample_sizes);
+    free(writes);
+    PerfCounters_close(&perf);
+}
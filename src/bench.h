@@ -8,6 +8,9 @@
 #include <cstddef>
 #endif
 
+#include "histogram.h"
+#include "fib.h"
+
 #define GB (1024UL * 1024UL * 1024UL)
 #define MB (1024UL * 1024UL)
 #define KB (1024UL)
@@ -15,15 +18,55 @@
 typedef struct {
     char *benchmark;
     char *implementation;
+    char *objects;
+    size_t quantum;
+    char *churn_object;
+    size_t churn;
+    size_t live;
+    char *population_list;
+    size_t lookups;
+    char *element;
+    size_t base;
+    char *fib_mode_name;
+    FibMode fib_mode;      // Parsed from fib_mode_name.
     char *pattern;
+    char *pattern_list;
     char *file;
+    char *cache_state;
     char *timing;
     size_t size;
     size_t sample_size;
+    char *sample_size_list;
     size_t min_load;
     size_t high_water_mark;
     size_t low_water_mark; 
+    size_t memory_max;
+    char *cgroup;
+    char *mmapfile_directory;
     size_t writes;
+    char *writes_list;
+    char *write_mode;
+    size_t burst;
+    double write_region;
+    bool write_baseline;
+    size_t threads;
+    double zipf_exponent;
+    double hot_accesses;
+    double hot_data;
+    size_t stride;
+    size_t window;
+    size_t latency_sample;
+    size_t memory_sample_interval;
+    bool perf;
+    bool instrument;
+    char *trace;
+    size_t trace_buffer;
+    size_t repeat;
+    size_t warmup;
+    bool reuse;
+    char *summary;
+    char *json;
+    bool pregenerate;
     unsigned int seed;
 } Arguments;
 
@@ -31,18 +74,32 @@ typedef void *AnySystem;
 typedef void *AnyObject;
 typedef void *AnySequence;
 
+// Index sequences are generated in batches, so that the execution loops do
+// not pay for an indirect call per access.
+#define SEQUENCE_BATCH_SIZE 4096
+
+// What an access does with the element: read it, overwrite it, or read it
+// and write back a value derived from it.
+typedef enum { ACCESS_READ = 0, ACCESS_WRITE, ACCESS_UPDATE } Access;
+
 typedef struct { 
-    size_t current; 
-    bool end; 
-    bool write; 
-} SequenceResult;
+    size_t length; 
+    size_t current[SEQUENCE_BATCH_SIZE]; 
+    uint8_t access[SEQUENCE_BATCH_SIZE]; 
+} SequenceBatch;
 
-typedef SequenceResult (*sequence_t)(Arguments *, AnySequence);
+// Fills the batch with up to SEQUENCE_BATCH_SIZE accesses and returns how
+// many it filled in. Returns 0 once the sequence is exhausted.
+typedef size_t (*sequence_t)(Arguments *, AnySequence, SequenceBatch *);
 
 typedef void  *(*system_setup_t)   (Arguments *);
 typedef void   (*system_teardown_t)(Arguments *, AnySystem);
 typedef void  *(*object_creation_t)(Arguments *, AnySystem);
 typedef void   (*object_cleanup_t) (Arguments *, AnySystem, AnyObject);
-typedef void   (*execution_t)      (Arguments *, AnySystem, AnyObject, AnySequence, sequence_t, volatile int64_t *oubliette);
+typedef void   (*execution_t)      (Arguments *, AnySystem, AnyObject, AnySequence, sequence_t, Histogram *latencies, volatile int64_t *oubliette);
 typedef size_t (*max_length_t)     (Arguments *, AnySystem, AnyObject);
 
+// Whether execution writes to the object: every `writes` reads, or on every
+// access with the only write mode. Objects are created read-only otherwise.
+bool config_has_writes(Arguments *config);
+
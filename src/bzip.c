@@ -8,6 +8,7 @@
 #include <assert.h>
 
 #include "logging.h"
+#include "instrument.h"
 #include "bzip.h"
 
 #include <bzlib.h>
@@ -986,6 +987,7 @@ BZip2 *BZip2_ufo_new(UfoCore *ufo_system, char *filename, bool read_only, size_t
     parameters.read_only = read_only;
     parameters.populate_data = blocks;
     parameters.populate_fn = BZip2_populate;
+    INSTRUMENT_PARAMETERS(parameters, "ufo");
 
     UfoObj ufo_object = ufo_new_object(ufo_system, &parameters);
     
@@ -1022,6 +1024,7 @@ void BZip2_ufo_free(UfoCore *ufo_system, BZip2 *object) {
     }
 
     // Free the blocks struct
+    UNINSTRUMENT_PARAMETERS(parameters);
     Blocks *data = (Blocks *) parameters.populate_data;
     Blocks_free(data);
 
@@ -1127,6 +1130,7 @@ Borough *BZip2_nyc_new(NycCore *system, char *filename, size_t min_load_count) {
     parameters.min_load_ct = min_load_count;
     parameters.populate_data = blocks;
     parameters.populate_fn = BZip2_populate;
+    INSTRUMENT_PARAMETERS(parameters, "nyc");
 
     Borough *object = (Borough *) malloc(sizeof(Borough));
     *object = nyc_new_borough(system, &parameters);
@@ -1143,6 +1147,7 @@ void BZip2_nyc_free(NycCore *system, Borough *object) {
     borough_params(object, &parameters);
 
     // Free the blocks struct
+    UNINSTRUMENT_PARAMETERS(parameters);
     Blocks *data = (Blocks *) parameters.populate_data;
     Blocks_free(data);
 
@@ -1170,6 +1175,7 @@ Village *BZip2_toronto_new(TorontoCore *system, char *filename, size_t min_load_
     parameters.min_load_ct = min_load_count;
     parameters.populate_data = blocks;
     parameters.populate_fn = BZip2_populate;
+    INSTRUMENT_PARAMETERS(parameters, "toronto");
 
     Village *object = (Village *) malloc(sizeof(Village));
     *object = toronto_new_village(system, &parameters);
@@ -1186,6 +1192,7 @@ void BZip2_toronto_free(TorontoCore *system, Village *object) {
     village_params(object, &parameters);
 
     // Free the blocks struct
+    UNINSTRUMENT_PARAMETERS(parameters);
     Blocks *data = (Blocks *) parameters.populate_data;
     Blocks_free(data);
 
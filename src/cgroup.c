@@ -0,0 +1,251 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <mntent.h>
+#include <sys/stat.h>
+
+#include "logging.h"
+#include "cgroup.h"
+
+static bool write_file(const char *path, const char *value) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        return false;
+    }
+    bool written = fputs(value, file) >= 0;
+    // Writes to cgroup files fail on close, since that is when they flush.
+    return fclose(file) == 0 && written;
+}
+
+static bool read_file(const char *path, char *buffer, size_t size) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return false;
+    }
+    size_t length = fread(buffer, sizeof(char), size - 1, file);
+    buffer[length] = '\0';
+    fclose(file);
+    return true;
+}
+
+static size_t read_size(const char *directory, const char *name) {
+    char path[PATH_MAX + 32];
+    char contents[64];
+    snprintf(path, sizeof(path), "%s/%s", directory, name);
+    if (!read_file(path, contents, sizeof(contents))) {
+        return 0;
+    }
+    return (size_t) strtoull(contents, NULL, 10);
+}
+
+static bool move_process(const char *directory) {
+    char path[PATH_MAX + 32];
+    char pid[32];
+    snprintf(path, sizeof(path), "%s/cgroup.procs", directory);
+    snprintf(pid, sizeof(pid), "%d", getpid());
+    return write_file(path, pid);
+}
+
+// Whether a space-separated list of controllers names the memory controller.
+static bool lists_memory(const char *directory, const char *name) {
+    char path[PATH_MAX + 32];
+    char contents[512];
+    snprintf(path, sizeof(path), "%s/%s", directory, name);
+    if (!read_file(path, contents, sizeof(contents))) {
+        return false;
+    }
+    for (char *word = strtok(contents, " \n"); word != NULL; word = strtok(NULL, " \n")) {
+        if (strcmp(word, "memory") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool enable_memory(const char *directory) {
+    char path[PATH_MAX + 32];
+    snprintf(path, sizeof(path), "%s/cgroup.subtree_control", directory);
+    return lists_memory(directory, "cgroup.subtree_control") || write_file(path, "+memory");
+}
+
+// Where the cgroup2 hierarchy is mounted, e.g. /sys/fs/cgroup, or
+// /sys/fs/cgroup/unified on hybrid systems.
+static bool cgroup2_mount(char *target, size_t size) {
+    FILE *mounts = setmntent("/proc/self/mounts", "r");
+    if (mounts == NULL) {
+        return false;
+    }
+    bool found = false;
+    struct mntent *entry;
+    while ((entry = getmntent(mounts)) != NULL) {
+        if (strcmp(entry->mnt_type, "cgroup2") == 0) {
+            snprintf(target, size, "%s", entry->mnt_dir);
+            found = true;
+            break;
+        }
+    }
+    endmntent(mounts);
+    return found;
+}
+
+// The process' own cgroup2 path, relative to the mount: the "0::" line of
+// /proc/self/cgroup.
+static bool cgroup2_own(char *target, size_t size) {
+    FILE *file = fopen("/proc/self/cgroup", "r");
+    if (file == NULL) {
+        return false;
+    }
+    bool found = false;
+    char line[PATH_MAX];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (strncmp(line, "0::", 3) == 0) {
+            line[strcspn(line, "\n")] = '\0';
+            found = snprintf(target, size, "%s", line + 3) < (int) size;
+            break;
+        }
+    }
+    fclose(file);
+    return found;
+}
+
+bool Cgroup_create(Cgroup *cgroup, const char *parent, size_t memory_max) {
+    memset(cgroup, 0, sizeof(Cgroup));
+    cgroup->memory_max = memory_max;
+
+    char mount[PATH_MAX / 2], own[PATH_MAX / 2];
+    if (!cgroup2_mount(mount, sizeof(mount)) || !cgroup2_own(own, sizeof(own))) {
+        WARN("No cgroup v2 hierarchy, running without a memory limit\n");
+        return false;
+    }
+    snprintf(cgroup->original, sizeof(cgroup->original), "%s%s", mount, strcmp(own, "/") == 0 ? "" : own);
+
+    char parent_path[PATH_MAX];
+    if (parent == NULL) {
+        snprintf(parent_path, sizeof(parent_path), "%s", cgroup->original);
+    } else if (strncmp(parent, mount, strlen(mount)) == 0) {
+        snprintf(parent_path, sizeof(parent_path), "%s", parent);
+    } else {
+        snprintf(parent_path, sizeof(parent_path), "%s/%s", mount, parent);
+    }
+    if (!lists_memory(parent_path, "cgroup.controllers")) {
+        WARN("The memory controller is not available in %s, running without a memory limit\n", parent_path);
+        return false;
+    }
+
+    // A cgroup with processes in it cannot hand controllers down to its
+    // children. If the parent is our own cgroup, try to get out of the way
+    // into a leaf of our own; that works if nothing else lives there, as in
+    // a delegated scope.
+    if (!enable_memory(parent_path)) {
+        if (strcmp(parent_path, cgroup->original) != 0) {
+            WARN("Cannot enable the memory controller below %s (%s), running without a memory limit\n",
+                parent_path, strerror(errno));
+            return false;
+        }
+        if (snprintf(cgroup->home, sizeof(cgroup->home), "%s/ufo-bench-%d-home", parent_path, getpid()) 
+                >= (int) sizeof(cgroup->home)
+            || (mkdir(cgroup->home, 0755) != 0 && errno != EEXIST) || !move_process(cgroup->home)) {
+            WARN("Cannot leave %s to enable the memory controller (%s), running without a memory limit\n",
+                parent_path, strerror(errno));
+            rmdir(cgroup->home);
+            cgroup->home[0] = '\0';
+            return false;
+        }
+        if (!enable_memory(parent_path)) {
+            WARN("Cannot enable the memory controller below %s (%s), running without a memory limit\n",
+                parent_path, strerror(errno));
+            Cgroup_destroy(cgroup);
+            return false;
+        }
+    }
+
+    if (snprintf(cgroup->path, sizeof(cgroup->path), "%s/ufo-bench-%d", parent_path, getpid()) 
+            >= (int) sizeof(cgroup->path)
+        || (mkdir(cgroup->path, 0755) != 0 && errno != EEXIST)) {
+        WARN("Cannot create cgroup %s (%s), running without a memory limit\n", cgroup->path, strerror(errno));
+        cgroup->path[0] = '\0';
+        Cgroup_destroy(cgroup);
+        return false;
+    }
+    char path[PATH_MAX + 32];
+    char value[32];
+    snprintf(path, sizeof(path), "%s/memory.max", cgroup->path);
+    snprintf(value, sizeof(value), "%lu", memory_max);
+    if (!write_file(path, value)) {
+        WARN("Cannot set %s (%s), running without a memory limit\n", path, strerror(errno));
+        Cgroup_destroy(cgroup);
+        return false;
+    }
+    cgroup->active = true;
+    return true;
+}
+
+bool Cgroup_enter(Cgroup *cgroup) {
+    if (!cgroup->active) {
+        return false;
+    }
+    if (!move_process(cgroup->path)) {
+        WARN("Cannot move into cgroup %s (%s), running without a memory limit\n", cgroup->path, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+void Cgroup_leave(Cgroup *cgroup) {
+    if (!cgroup->active) {
+        return;
+    }
+    const char *target = cgroup->home[0] != '\0' ? cgroup->home : cgroup->original;
+    if (!move_process(target)) {
+        WARN("Cannot move back into cgroup %s (%s)\n", target, strerror(errno));
+    }
+}
+
+void Cgroup_read(Cgroup *cgroup, CgroupStats *stats) {
+    memset(stats, 0, sizeof(CgroupStats));
+    if (!cgroup->active) {
+        return;
+    }
+    char path[PATH_MAX + 32];
+    char contents[512];
+    snprintf(path, sizeof(path), "%s/memory.events", cgroup->path);
+    if (read_file(path, contents, sizeof(contents))) {
+        char *saveptr = NULL;
+        for (char *line = strtok_r(contents, "\n", &saveptr); line != NULL; line = strtok_r(NULL, "\n", &saveptr)) {
+            char key[32];
+            unsigned long long value;
+            if (sscanf(line, "%31s %llu", key, &value) != 2) continue;
+            if (strcmp(key, "low") == 0) stats->low = value;
+            if (strcmp(key, "high") == 0) stats->high = value;
+            if (strcmp(key, "max") == 0) stats->max = value;
+            if (strcmp(key, "oom") == 0) stats->oom = value;
+            if (strcmp(key, "oom_kill") == 0) stats->oom_kill = value;
+        }
+    }
+    stats->memory_current = read_size(cgroup->path, "memory.current");
+    stats->memory_peak = read_size(cgroup->path, "memory.peak");
+    stats->swap_current = read_size(cgroup->path, "memory.swap.current");
+    stats->swap_peak = read_size(cgroup->path, "memory.swap.peak");
+}
+
+// Memory still charged to the cgroup when it is removed moves to its parent.
+void Cgroup_destroy(Cgroup *cgroup) {
+    if (cgroup->path[0] != '\0' && rmdir(cgroup->path) != 0 && errno != ENOENT) {
+        WARN("Cannot remove cgroup %s (%s)\n", cgroup->path, strerror(errno));
+    }
+    // Our own cgroup only takes processes again once it stops handing the
+    // memory controller down, which only we asked it to do.
+    if (cgroup->home[0] != '\0') {
+        char path[PATH_MAX + 32];
+        snprintf(path, sizeof(path), "%s/cgroup.subtree_control", cgroup->original);
+        write_file(path, "-memory");
+        if (!move_process(cgroup->original)) {
+            WARN("Cannot move back into cgroup %s (%s)\n", cgroup->original, strerror(errno));
+        } else {
+            rmdir(cgroup->home);
+        }
+    }
+    cgroup->active = false;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <limits.h>
+
+// A cgroup v2 child of the benchmark's own cgroup (or of a given parent
+// cgroup) with a memory.max limit, created for one repetition. The process
+// moves into it before object creation and leaves after execution: charges
+// do not follow a process that moves, so only memory allocated or faulted in
+// while inside is charged to it. Every step can fail without root or a
+// delegated cgroup subtree; the benchmark then runs without a limit, and
+// says so.
+typedef struct {
+    bool active;
+    size_t memory_max;
+    char path[PATH_MAX];       // The benchmark's cgroup.
+    char original[PATH_MAX];   // The cgroup the process came from.
+    char home[PATH_MAX];       // Where the process waits outside of execution, 
+                               // if it had to leave its own cgroup, or empty.
+} Cgroup;
+
+// Counters of the benchmark's cgroup. memory.events counts are cumulative,
+// sizes are in bytes. Peaks are zero if the kernel does not provide them.
+typedef struct {
+    uint64_t low;
+    uint64_t high;
+    uint64_t max;
+    uint64_t oom;
+    uint64_t oom_kill;
+    size_t memory_current;
+    size_t memory_peak;
+    size_t swap_current;
+    size_t swap_peak;
+} CgroupStats;
+
+// Returns false, after a warning, if the cgroup cannot be set up. `parent`
+// is a path under the cgroup2 mount, or NULL for the current cgroup.
+bool Cgroup_create(Cgroup *cgroup, const char *parent, size_t memory_max);
+bool Cgroup_enter(Cgroup *cgroup);
+void Cgroup_leave(Cgroup *cgroup);
+void Cgroup_read(Cgroup *cgroup, CgroupStats *stats);
+void Cgroup_destroy(Cgroup *cgroup);
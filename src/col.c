@@ -3,6 +3,7 @@
 #include <stdlib.h>
 
 #include "logging.h"
+#include "instrument.h"
 
 #include "col.h"
 
@@ -34,6 +35,7 @@ int32_t *col_ufo_new(UfoCore *ufo_system, int32_t **source, size_t column, size_
     parameters.read_only = false;
     parameters.populate_data = data;
     parameters.populate_fn = col_populate;
+    INSTRUMENT_PARAMETERS(parameters, "ufo");
 
     UfoObj ufo_object = ufo_new_object(ufo_system, &parameters);
     if (ufo_is_error(&ufo_object)) {
@@ -57,6 +59,7 @@ void col_ufo_free(UfoCore *ufo_system, int64_t *ptr) {
     if (result < 0) {
         REPORT("Unable to access UFO parameters, so cannot free source matrix\n");
     }
+    UNINSTRUMENT_PARAMETERS(parameters);
     free(parameters.populate_data);
 
     ufo_free(ufo_object);
@@ -90,6 +93,7 @@ Borough *col_nyc_new(NycCore *system, int32_t **source, size_t column, size_t si
     parameters.min_load_ct = min_load_count;
     parameters.populate_data = data;
     parameters.populate_fn = col_populate;
+    INSTRUMENT_PARAMETERS(parameters, "nyc");
 
     Borough *object = (Borough *) malloc(sizeof(Borough));
     *object = nyc_new_borough(system, &parameters);
@@ -103,6 +107,7 @@ Borough *col_nyc_new(NycCore *system, int32_t **source, size_t column, size_t si
 void col_nyc_free(NycCore *system, Borough *object) {
     BoroughParameters parameters;
     borough_params(object, &parameters);
+    UNINSTRUMENT_PARAMETERS(parameters);
     free(parameters.populate_data);
     borough_free(*object);
     free(object);
@@ -121,6 +126,7 @@ Village *col_toronto_new(TorontoCore *system, int32_t **source, size_t column, s
     parameters.min_load_ct = min_load_count;
     parameters.populate_data = data;
     parameters.populate_fn = col_populate;
+    INSTRUMENT_PARAMETERS(parameters, "toronto");
 
     Village *object = (Village *) malloc(sizeof(Village));
     *object = toronto_new_village(system, &parameters);
@@ -134,6 +140,7 @@ Village *col_toronto_new(TorontoCore *system, int32_t **source, size_t column, s
 void col_toronto_free(TorontoCore *system, Village *object) {
     VillageParameters parameters;
     village_params(object, &parameters);
+    UNINSTRUMENT_PARAMETERS(parameters);
     free(parameters.populate_data);  
     village_free(*object);
     free(object);
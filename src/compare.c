@@ -0,0 +1,336 @@
+#define _GNU_SOURCE
+#include <argp.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "logging.h"
+#include "stats.h"
+
+// Compares two sets of NDJSON results written by `bench --json` and flags
+// statistically significant regressions of one metric. Results are grouped
+// by benchmark, implementation, and the parameters that change what is
+// measured; each group is compared with Welch's t-test.
+//
+// Exits with 1 if any group regressed, so it can gate upgrades.
+
+typedef struct {
+    char *baseline;
+    char *candidate;
+    char *metric;
+    double threshold;
+} CompareArguments;
+
+typedef struct {
+    size_t count;
+    size_t capacity;
+    double *values;
+} Samples;
+
+typedef struct {
+    char *key;
+    Samples baseline;
+    Samples candidate;
+} Group;
+
+typedef struct {
+    size_t count;
+    size_t capacity;
+    Group *groups;
+} Groups;
+
+static error_t parse_opt (int key, char *value, struct argp_state *state) {
+    CompareArguments *arguments = state->input;
+    switch (key) {
+        case 'm': arguments->metric = value; break;
+        case 'x': arguments->threshold = atof(value); break;
+        case ARGP_KEY_ARG:
+            if (state->arg_num == 0) arguments->baseline = value;
+            else if (state->arg_num == 1) arguments->candidate = value;
+            else argp_usage(state);
+            break;
+        case ARGP_KEY_END:
+            if (state->arg_num < 2) argp_usage(state);
+            break;
+        default:  return ARGP_ERR_UNKNOWN;
+    }
+    return 0;
+}
+
+static void Samples_push(Samples *samples, double value) {
+    if (samples->count == samples->capacity) {
+        samples->capacity = samples->capacity == 0 ? 16 : samples->capacity * 2;
+        samples->values = (double *) realloc(samples->values, sizeof(double) * samples->capacity);
+    }
+    samples->values[samples->count++] = value;
+}
+
+static Group *Groups_find(Groups *groups, const char *key) {
+    for (size_t i = 0; i < groups->count; i++) {
+        if (strcmp(groups->groups[i].key, key) == 0) {
+            return &groups->groups[i];
+        }
+    }
+    if (groups->count == groups->capacity) {
+        groups->capacity = groups->capacity == 0 ? 16 : groups->capacity * 2;
+        groups->groups = (Group *) realloc(groups->groups, sizeof(Group) * groups->capacity);
+    }
+    Group *group = &groups->groups[groups->count++];
+    memset(group, 0, sizeof(Group));
+    group->key = strdup(key);
+    return group;
+}
+
+// The records are written by bench, so the keys we look for are unique in a
+// line and do not need a full JSON parser.
+static char *json_field(char *line, const char *key) {
+    char pattern[128];
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    char *field = strstr(line, pattern);
+    return field == NULL ? NULL : field + strlen(pattern);
+}
+
+static bool json_string_field(char *line, const char *key, char *target, size_t size) {
+    char *value = json_field(line, key);
+    if (value == NULL || *value != '"') {
+        return false;
+    }
+    value++;
+    size_t length = strcspn(value, "\"");
+    if (length >= size) {
+        length = size - 1;
+    }
+    memcpy(target, value, length);
+    target[length] = '\0';
+    return true;
+}
+
+static bool json_number_field(char *line, const char *key, double *target) {
+    char *value = json_field(line, key);
+    if (value == NULL) {
+        return false;
+    }
+    char *end;
+    *target = strtod(value, &end);
+    return end != value;
+}
+
+static void key_append(char *key, size_t size, const char *format, ...) {
+    size_t used = strlen(key);
+    if (used >= size) {
+        return;
+    }
+    va_list arguments;
+    va_start(arguments, format);
+    vsnprintf(key + used, size - used, format, arguments);
+    va_end(arguments);
+}
+
+static void key_append_string(char *line, char *key, size_t size, const char *field) {
+    char value[256];
+    if (json_string_field(line, field, value, sizeof(value))) {
+        key_append(key, size, " %s=%s", field, value);
+    }
+}
+
+static void key_append_number(char *line, char *key, size_t size, const char *field) {
+    double value;
+    if (json_number_field(line, field, &value)) {
+        key_append(key, size, " %s=%g", field, value);
+    }
+}
+
+static void key_append_bool(char *line, char *key, size_t size, const char *field) {
+    char *value = json_field(line, field);
+    if (value != NULL) {
+        key_append(key, size, " %s=%s", field, strncmp(value, "true", 4) == 0 ? "yes" : "no");
+    }
+}
+
+// What identifies a group: every argument bench records that changes what
+// is measured. Arguments that only matter to some benchmarks, patterns,
+// implementations or write modes are left out of the others, so that runs
+// which differ only in an unused default still pool together.
+static bool group_key(char *line, char *key, size_t size) {
+    char benchmark[64], implementation[64], pattern[64], write_mode[32];
+    double writes;
+    if (!json_string_field(line, "benchmark", benchmark, sizeof(benchmark))
+        || !json_string_field(line, "implementation", implementation, sizeof(implementation))
+        || !json_string_field(line, "pattern", pattern, sizeof(pattern))
+        || !json_number_field(line, "writes", &writes)) {
+        return false;
+    }
+    if (!json_string_field(line, "write_mode", write_mode, sizeof(write_mode))) {
+        strcpy(write_mode, "interval");
+    }
+    key[0] = '\0';
+    key_append(key, size, "%s/%s pattern=%s", benchmark, implementation, pattern);
+    key_append_number(line, key, size, "size");
+    key_append_number(line, key, size, "sample_size");
+    key_append_number(line, key, size, "writes");
+    key_append_number(line, key, size, "threads");
+    key_append_number(line, key, size, "memory_max");
+    key_append_string(line, key, size, "cache_state");
+    key_append_bool(line, key, size, "reuse");
+    key_append_bool(line, key, size, "pregenerate");
+    key_append_bool(line, key, size, "instrument");
+    key_append_bool(line, key, size, "perf");
+    key_append_number(line, key, size, "latency_sample");
+
+    // The pattern's own parameters.
+    if (strcmp(pattern, "zipf") == 0) {
+        key_append_number(line, key, size, "zipf_exponent");
+    }
+    if (strcmp(pattern, "hotset") == 0) {
+        key_append_number(line, key, size, "hot_accesses");
+        key_append_number(line, key, size, "hot_data");
+    }
+    if (strcmp(pattern, "stride") == 0) {
+        key_append_number(line, key, size, "stride");
+    }
+    if (strcmp(pattern, "chunk-random") == 0) {
+        key_append_number(line, key, size, "window");
+    }
+
+    // The write mode's, where there are writes at all.
+    if (writes != 0 || strcmp(write_mode, "only") == 0) {
+        key_append(key, size, " write_mode=%s", write_mode);
+        if (strcmp(write_mode, "burst") == 0) {
+            key_append_number(line, key, size, "burst");
+        }
+        if (strcmp(write_mode, "hot") == 0) {
+            key_append_number(line, key, size, "write_region");
+        }
+    }
+
+    // Min load and the water marks only matter for the systems that load
+    // in chunks.
+    if (strcmp(implementation, "ufo") == 0 || strcmp(implementation, "nyc") == 0 
+        || strcmp(implementation, "toronto") == 0) {
+        key_append_number(line, key, size, "min_load");
+        key_append_number(line, key, size, "high_water_mark");
+        key_append_number(line, key, size, "low_water_mark");
+    }
+    if (strcmp(implementation, "mmapfile") == 0) {
+        key_append_string(line, key, size, "mmapfile_dir");
+    }
+
+    // The input file only matters for the benchmarks that read it.
+    if (strcmp(benchmark, "bzip") == 0 || strcmp(benchmark, "mmap") == 0 
+        || strcmp(benchmark, "mix") == 0 || strcmp(benchmark, "churn") == 0) {
+        key_append_string(line, key, size, "file");
+    }
+    // The element type only matters for tseq, the fib mode for fib. The
+    // rest is only written by the benchmarks it matters to.
+    if (strcmp(benchmark, "tseq") == 0) {
+        key_append_string(line, key, size, "element");
+    }
+    key_append_string(line, key, size, "fib_mode");
+    key_append_number(line, key, size, "base");
+    key_append_string(line, key, size, "objects");
+    key_append_number(line, key, size, "quantum");
+    key_append_string(line, key, size, "churn_object");
+    key_append_number(line, key, size, "churn");
+    key_append_number(line, key, size, "live");
+    key_append_string(line, key, size, "populations");
+    key_append_number(line, key, size, "lookups");
+    return true;
+}
+
+static int read_results(const char *path, const char *metric, Groups *groups, bool candidate) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        REPORT("Cannot open results file \"%s\"\n", path);
+        return -1;
+    }
+    char *line = NULL;
+    size_t capacity = 0;
+    size_t line_number = 0;
+    while (getline(&line, &capacity, file) != -1) {
+        line_number++;
+        if (line[0] != '{') {
+            continue;
+        }
+        char key[1024];
+        double value;
+        if (!group_key(line, key, sizeof(key)) || !json_number_field(line, metric, &value)) {
+            WARN("Skipping %s:%lu, cannot find the group or metric \"%s\"\n", path, line_number, metric);
+            continue;
+        }
+        Group *group = Groups_find(groups, key);
+        Samples_push(candidate ? &group->candidate : &group->baseline, value);
+    }
+    free(line);
+    fclose(file);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    CompareArguments config;
+    config.baseline = NULL;
+    config.candidate = NULL;
+    config.metric = "execution_time";
+    config.threshold = 0;
+
+    static char doc[] = "Compares two sets of bench NDJSON results and flags significant regressions.";
+    static char args_doc[] = "BASELINE CANDIDATE";
+    static struct argp_option options[] = {
+        {"metric",          'm', "KEY",            0,  "Metric to compare: any numeric field, e.g. execution_time, object_creation_time, throughput, p99; default: execution_time"},
+        {"threshold",       'x', "X%%",            0,  "Ignore significant changes smaller than X%% of the baseline mean, default: 0"},
+        { 0 }
+    };
+    static struct argp argp = { options, parse_opt, args_doc, doc };
+    argp_parse (&argp, argc, argv, 0, 0, &config);
+
+    // Throughput is the only metric we record for which more is better.
+    bool higher_is_better = strcmp(config.metric, "throughput") == 0;
+
+    Groups groups = { 0, 0, NULL };
+    if (read_results(config.baseline, config.metric, &groups, false) != 0
+        || read_results(config.candidate, config.metric, &groups, true) != 0) {
+        return 2;
+    }
+
+    size_t regressions = 0;
+    printf("%-8s %-12s %14s %14s %9s %8s %7s  %s\n",
+        "verdict", "n", "baseline", "candidate", "change", "t", "df", "group");
+    for (size_t i = 0; i < groups.count; i++) {
+        Group *group = &groups.groups[i];
+        Summary baseline, candidate;
+        Summary_compute(&baseline, group->baseline.values, group->baseline.count);
+        Summary_compute(&candidate, group->candidate.values, group->candidate.count);
+
+        double t, degrees_of_freedom;
+        bool significant = welch_test(&baseline, &candidate, &t, &degrees_of_freedom);
+        double change = baseline.mean == 0 ? 0 : 100.0 * (candidate.mean - baseline.mean) / baseline.mean;
+        bool worse = higher_is_better ? change < -config.threshold : change > config.threshold;
+        bool better = higher_is_better ? change > config.threshold : change < -config.threshold;
+
+        const char *verdict;
+        if (baseline.count < 2 || candidate.count < 2) {
+            verdict = "n/a";
+        } else if (significant && worse) {
+            verdict = "WORSE";
+            regressions++;
+        } else if (significant && better) {
+            verdict = "better";
+        } else {
+            verdict = "same";
+        }
+
+        char counts[32];
+        snprintf(counts, sizeof(counts), "%lu/%lu", baseline.count, candidate.count);
+        printf("%-8s %-12s %14.0f %14.0f %8.2f%% %8.2f %7.1f  %s\n",
+            verdict, counts, baseline.mean, candidate.mean, change, t, degrees_of_freedom, group->key);
+
+        free(group->key);
+        free(group->baseline.values);
+        free(group->candidate.values);
+    }
+    free(groups.groups);
+
+    INFO("%lu of %lu groups regressed in %s\n", regressions, groups.count, config.metric);
+    return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <mntent.h>
+#include <sys/utsname.h>
+
+#include "logging.h"
+#include "environment.h"
+
+#define UNKNOWN "unknown"
+
+// Reads the first line of a small file, without the trailing newline.
+static int read_line(const char *path, char *buffer, size_t size) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+    char *line = fgets(buffer, size, file);
+    fclose(file);
+    if (line == NULL) {
+        return -1;
+    }
+    buffer[strcspn(buffer, "\n")] = '\0';
+    return 0;
+}
+
+static void copy(char *target, size_t size, const char *source) {
+    size_t length = strlen(source);
+    if (length > size - 1) {
+        length = size - 1;
+    }
+    memcpy(target, source, length);
+    target[length] = '\0';
+}
+
+// The model name of the first processor listed in /proc/cpuinfo.
+static void cpu_model(char *target, size_t size) {
+    copy(target, size, UNKNOWN);
+    FILE *file = fopen("/proc/cpuinfo", "r");
+    if (file == NULL) {
+        return;
+    }
+    char line[512];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (strncmp(line, "model name", strlen("model name")) != 0) {
+            continue;
+        }
+        char *value = strchr(line, ':');
+        if (value != NULL) {
+            value++;
+            while (*value == ' ' || *value == '\t') value++;
+            value[strcspn(value, "\n")] = '\0';
+            copy(target, size, value);
+        }
+        break;
+    }
+    fclose(file);
+}
+
+// The sysfs file lists all modes with the selected one in brackets, e.g.
+// "always [madvise] never".
+static void transparent_hugepages(char *target, size_t size) {
+    copy(target, size, UNKNOWN);
+    char line[256];
+    if (read_line("/sys/kernel/mm/transparent_hugepage/enabled", line, sizeof(line)) != 0) {
+        return;
+    }
+    char *start = strchr(line, '[');
+    char *end = start == NULL ? NULL : strchr(start, ']');
+    if (start == NULL || end == NULL) {
+        return;
+    }
+    *end = '\0';
+    copy(target, size, start + 1);
+}
+
+static int unprivileged_userfaultfd() {
+    char line[32];
+    if (read_line("/proc/sys/vm/unprivileged_userfaultfd", line, sizeof(line)) != 0) {
+        return -1;
+    }
+    return atoi(line);
+}
+
+// The type of the mount with the longest directory that contains `path`.
+static void filesystem_type(const char *path, char *target, size_t size) {
+    copy(target, size, UNKNOWN);
+    FILE *mounts = setmntent("/proc/self/mounts", "r");
+    if (mounts == NULL) {
+        return;
+    }
+    size_t best = 0;
+    struct mntent *mount;
+    while ((mount = getmntent(mounts)) != NULL) {
+        size_t length = strlen(mount->mnt_dir);
+        bool contains = strncmp(path, mount->mnt_dir, length) == 0 
+            && (path[length] == '\0' || path[length] == '/' || length == 1);
+        if (contains && length >= best) {
+            best = length;
+            copy(target, size, mount->mnt_type);
+        }
+    }
+    endmntent(mounts);
+}
+
+void Environment_capture(Environment *environment) {
+    if (gethostname(environment->hostname, sizeof(environment->hostname)) != 0) {
+        copy(environment->hostname, sizeof(environment->hostname), UNKNOWN);
+    }
+
+    struct utsname name;
+    if (uname(&name) == 0) {
+        snprintf(environment->kernel, sizeof(environment->kernel), "%s %s", name.release, name.version);
+        copy(environment->machine, sizeof(environment->machine), name.machine);
+    } else {
+        copy(environment->kernel, sizeof(environment->kernel), UNKNOWN);
+        copy(environment->machine, sizeof(environment->machine), UNKNOWN);
+    }
+
+    cpu_model(environment->cpu_model, sizeof(environment->cpu_model));
+    environment->cores = sysconf(_SC_NPROCESSORS_ONLN);
+    transparent_hugepages(environment->transparent_hugepages, sizeof(environment->transparent_hugepages));
+    environment->unprivileged_userfaultfd = unprivileged_userfaultfd();
+    filesystem_type("/tmp", environment->tmp_filesystem, sizeof(environment->tmp_filesystem));
+
+    time_t now = time(NULL);
+    struct tm utc;
+    gmtime_r(&now, &utc);
+    strftime(environment->timestamp, sizeof(environment->timestamp), "%Y-%m-%dT%H:%M:%SZ", &utc);
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <stddef.h>
+
+// Description of the machine a benchmark ran on, recorded alongside the
+// results so that runs from different machines or kernel settings are not
+// compared by accident. Anything that cannot be read is left as "unknown"
+// (or -1 for numbers).
+typedef struct {
+    char hostname[256];
+    char kernel[256];                 // uname release and version.
+    char machine[64];
+    char cpu_model[256];
+    long cores;                       // Online processors.
+    char transparent_hugepages[32];   // Selected THP mode, e.g. "madvise".
+    int unprivileged_userfaultfd;     // vm.unprivileged_userfaultfd.
+    char tmp_filesystem[64];          // Type of the filesystem mounted at /tmp.
+    char timestamp[32];               // UTC, ISO 8601.
+} Environment;
+
+void Environment_capture(Environment *environment);
@@ -3,18 +3,60 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include "instrument.h"
 
 typedef struct {
     uint64_t *self;
+    FibMode mode;
 } Fib;
 
+static const char *fib_mode_names[] = { "chained", "independent", NULL };
+
+bool fib_mode_parse(const char *name, FibMode *mode) {
+    for (size_t i = 0; fib_mode_names[i] != NULL; i++) {
+        if (strcmp(fib_mode_names[i], name) == 0) {
+            *mode = (FibMode) i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Elements index and index + 1, that is F(index + 1) and F(index + 2) with
+// F(0) = 0 and F(1) = 1, by fast doubling:
+//   F(2k) = F(k) * (2 * F(k + 1) - F(k)),  F(2k + 1) = F(k)^2 + F(k + 1)^2
+// Unsigned arithmetic wraps around at 2^64 like the additions do.
+static void fib_pair(size_t index, uint64_t *first, uint64_t *second) {
+    uint64_t n = (uint64_t) index + 1;
+    uint64_t a = 0, b = 1;  // F(k), F(k + 1) for the bits of n seen so far.
+    for (int bit = 63 - __builtin_clzll(n); bit >= 0; bit--) {
+        uint64_t even = a * (2 * b - a);
+        uint64_t odd = a * a + b * b;
+        if ((n >> bit) & 1) {
+            a = odd;
+            b = even + odd;
+        } else {
+            a = even;
+            b = odd;
+        }
+    }
+    *first = a;
+    *second = b;
+}
+
 int32_t fib_populate(void* user_data, uintptr_t start, uintptr_t end, unsigned char* target_bytes) {
     Fib *data = (Fib *) user_data;
     // printf("poppp %p\n", user_data);
     uint64_t *target = (uint64_t *) target_bytes;
 
-    target[0] = (start == 0) ? 1 : data->self[start-1] + data->self[start-2];
-    target[1] = (start == 0) ? 1 : target[0] + data->self[start-1];
+    if (data->mode == FIB_INDEPENDENT) {
+        fib_pair(start, &target[0], &target[1]);
+    } else {
+        target[0] = (start == 0) ? 1 : data->self[start-1] + data->self[start-2];
+        target[1] = (start == 0) ? 1 : target[0] + data->self[start-1];
+    }
 
     size_t length = end - start;
     for (size_t i = 2; i < length; i++) {
@@ -24,10 +66,11 @@ int32_t fib_populate(void* user_data, uintptr_t start, uintptr_t end, unsigned c
     return 0;
 }
 
-uint64_t *ufo_fib_new(UfoCore *ufo_system, size_t n, bool read_only, size_t min_load_count) {
+uint64_t *ufo_fib_new(UfoCore *ufo_system, size_t n, FibMode mode, bool read_only, size_t min_load_count) {
 
     Fib *data = (Fib *) malloc(sizeof(Fib));
     data->self = NULL;
+    data->mode = mode;
 
     UfoParameters parameters;
     parameters.header_size = 0;
@@ -37,6 +80,7 @@ uint64_t *ufo_fib_new(UfoCore *ufo_system, size_t n, bool read_only, size_t min_
     parameters.read_only = read_only;
     parameters.populate_data = data;
     parameters.populate_fn = fib_populate;
+    INSTRUMENT_PARAMETERS(parameters, "ufo");
 
     UfoObj ufo_object = ufo_new_object(ufo_system, &parameters);
 
@@ -63,6 +107,7 @@ void ufo_fib_free(UfoCore *ufo_system, uint64_t *ptr) {
         ufo_free(ufo_object);
         return;
     }
+    UNINSTRUMENT_PARAMETERS(parameters);
     free(parameters.populate_data);
     ufo_free(ufo_object);
 }
@@ -84,10 +129,11 @@ void normil_fib_free(uint64_t * ptr) {
     free(ptr);
 }
 
-Borough *nyc_fib_new(NycCore *system, size_t n, size_t min_load_count) {
+Borough *nyc_fib_new(NycCore *system, size_t n, FibMode mode, size_t min_load_count) {
 
     Fib *data = (Fib *) malloc(sizeof(Fib));
     data->self = NULL;
+    data->mode = mode;
 
     BoroughParameters parameters;
     parameters.header_size = 0;
@@ -96,6 +142,7 @@ Borough *nyc_fib_new(NycCore *system, size_t n, size_t min_load_count) {
     parameters.min_load_ct = min_load_count;
     parameters.populate_data = data;
     parameters.populate_fn = fib_populate;
+    INSTRUMENT_PARAMETERS(parameters, "nyc");
 
     printf("vv %p\n", parameters.populate_data);
 
@@ -116,6 +163,7 @@ void nyc_fib_free(NycCore *system, Borough *object) {
     printf("ww in %p\n", &parameters);
     borough_params(object, &parameters);
     printf("vv %p\n", &parameters);
+    UNINSTRUMENT_PARAMETERS(parameters);
     printf("vv %p\n", parameters.populate_data);
     free(parameters.populate_data);
     printf("xx\n");
@@ -125,10 +173,11 @@ void nyc_fib_free(NycCore *system, Borough *object) {
     printf("zz\n");
 }
 
-Village *toronto_fib_new(TorontoCore *system, size_t n, size_t min_load_count) {
+Village *toronto_fib_new(TorontoCore *system, size_t n, FibMode mode, size_t min_load_count) {
 
     Fib *data = (Fib *) malloc(sizeof(Fib));
     data->self = NULL;
+    data->mode = mode;
 
     VillageParameters parameters;
     parameters.header_size = 0;
@@ -137,6 +186,7 @@ Village *toronto_fib_new(TorontoCore *system, size_t n, size_t min_load_count) {
     parameters.min_load_ct = min_load_count;
     parameters.populate_data = data;
     parameters.populate_fn = fib_populate;
+    INSTRUMENT_PARAMETERS(parameters, "toronto");
 
     Village *object = (Village *) malloc(sizeof(Village));
     *object = toronto_new_village(system, &parameters);
@@ -152,6 +202,7 @@ Village *toronto_fib_new(TorontoCore *system, size_t n, size_t min_load_count) {
 void toronto_fib_free(TorontoCore *system, Village *object) { 
     VillageParameters parameters;
     village_params(object, &parameters);
+    UNINSTRUMENT_PARAMETERS(parameters);
     free(parameters.populate_data);
     village_free(*object);
     free(object);
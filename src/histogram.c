@@ -0,0 +1,50 @@
+#include <string.h>
+
+#include "histogram.h"
+
+void Histogram_init(Histogram *histogram, size_t period) {
+    memset(histogram, 0, sizeof(Histogram));
+    histogram->period = period;
+    histogram->countdown = period;
+}
+
+void Histogram_merge(Histogram *into, const Histogram *from) {
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        into->buckets[i] += from->buckets[i];
+    }
+    into->count += from->count;
+    if (from->max > into->max) {
+        into->max = from->max;
+    }
+}
+
+// The highest value that falls into the given bucket.
+static uint64_t Histogram_bucket_upper_bound(size_t bucket) {
+    if (bucket < HISTOGRAM_SUB_BUCKETS) {
+        return bucket;
+    }
+    size_t major = bucket / HISTOGRAM_SUB_BUCKETS;
+    size_t minor = bucket % HISTOGRAM_SUB_BUCKETS;
+    uint64_t lower_bound = ((uint64_t) (minor + HISTOGRAM_SUB_BUCKETS)) << (major - 1);
+    return lower_bound + ((1UL << (major - 1)) - 1);
+}
+
+// Percentile is given in percent, eg. 99.9. Returns 0 for an empty histogram.
+uint64_t Histogram_percentile(const Histogram *histogram, double percentile) {
+    if (histogram->count == 0) {
+        return 0;
+    }
+    uint64_t rank = (uint64_t) ((percentile / 100.0) * (double) histogram->count + 0.5);
+    if (rank < 1) {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += histogram->buckets[i];
+        if (seen >= rank) {
+            uint64_t value = Histogram_bucket_upper_bound(i);
+            return value < histogram->max ? value : histogram->max;
+        }
+    }
+    return histogram->max;
+}
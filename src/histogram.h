@@ -0,0 +1,55 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Log-bucketed latency histogram in the style of HdrHistogram: values are
+// grouped by the position of their highest bit, and each such power of two
+// range is split into HISTOGRAM_SUB_BUCKETS linear sub-buckets. This keeps the
+// relative error under 1/HISTOGRAM_SUB_BUCKETS (~3%) for any value up to
+// 2^64 with a fixed-size bucket array.
+#define HISTOGRAM_SUB_BUCKET_BITS 5
+#define HISTOGRAM_SUB_BUCKETS (1UL << HISTOGRAM_SUB_BUCKET_BITS)
+#define HISTOGRAM_BUCKETS ((64 - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+typedef struct {
+    size_t period;     // Record one in every `period` samples, 0 for none.
+    size_t countdown;
+    uint64_t count;
+    uint64_t max;
+    uint64_t buckets[HISTOGRAM_BUCKETS];
+} Histogram;
+
+void Histogram_init(Histogram *histogram, size_t period);
+void Histogram_merge(Histogram *into, const Histogram *from);
+uint64_t Histogram_percentile(const Histogram *histogram, double percentile);
+
+// Returns true if the current sample should be recorded.
+static inline bool Histogram_tick(Histogram *histogram) {
+    if (histogram == NULL || histogram->period == 0) {
+        return false;
+    }
+    if (--histogram->countdown != 0) {
+        return false;
+    }
+    histogram->countdown = histogram->period;
+    return true;
+}
+
+static inline size_t Histogram_bucket(uint64_t value) {
+    if (value < HISTOGRAM_SUB_BUCKETS) {
+        return (size_t) value;
+    }
+    size_t top_bit = 63 - __builtin_clzl(value);
+    size_t major = top_bit - HISTOGRAM_SUB_BUCKET_BITS + 1;
+    size_t minor = (size_t) (value >> (top_bit - HISTOGRAM_SUB_BUCKET_BITS)) - HISTOGRAM_SUB_BUCKETS;
+    return major * HISTOGRAM_SUB_BUCKETS + minor;
+}
+
+static inline void Histogram_record(Histogram *histogram, uint64_t value) {
+    histogram->buckets[Histogram_bucket(value)]++;
+    histogram->count++;
+    if (value > histogram->max) {
+        histogram->max = value;
+    }
+}
@@ -0,0 +1,197 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+
+#include "logging.h"
+#include "instrument.h"
+#include "timing.h"
+#include "trace.h"
+
+typedef struct {
+    populate_t populate_fn;
+    void *populate_data;
+    size_t element_size;
+    const char *backend;
+    PopulateCounters *scope;
+} InstrumentedPopulate;
+
+// Every thread claims a slot the first time it runs a callback and gives it
+// back when it exits. The next thread to claim a slot moves what the previous
+// one counted to `retired`, starts from zero and bumps the generation, so a
+// row never mixes two threads and totals only ever grow. Threads beyond
+// INSTRUMENT_MAX_THREADS alive at once share the extra slot at the end, which
+// is never handed out on its own, hence the atomic updates.
+static PopulateThread threads[INSTRUMENT_MAX_THREADS + 1] = {
+    [INSTRUMENT_MAX_THREADS] = { .tid = 0, .backend = "overflow", .overflow = true },
+};
+static size_t threads_count = 0;
+static size_t free_slots[INSTRUMENT_MAX_THREADS];
+static size_t free_slots_count = 0;
+static size_t overflowed = 0;
+static PopulateCounters retired;
+static pthread_mutex_t slots_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t slot_key;
+static pthread_once_t slot_key_once = PTHREAD_ONCE_INIT;
+static __thread PopulateThread *current_thread = NULL;
+static bool enabled = false;
+static PopulateCounters *scope = NULL;
+
+void instrument_enable(bool enable) {
+    enabled = enable;
+}
+
+bool instrument_enabled() {
+    return enabled;
+}
+
+void instrument_scope(PopulateCounters *counters) {
+    scope = counters;
+}
+
+static void instrument_release(void *thread) {
+    pthread_mutex_lock(&slots_lock);
+    free_slots[free_slots_count++] = (PopulateThread *) thread - threads;
+    pthread_mutex_unlock(&slots_lock);
+}
+
+static void instrument_create_key() {
+    pthread_key_create(&slot_key, instrument_release);
+}
+
+static PopulateThread *instrument_thread(const char *backend) {
+    if (__builtin_expect(current_thread == NULL, 0)) {
+        pthread_once(&slot_key_once, instrument_create_key);
+        pthread_mutex_lock(&slots_lock);
+        PopulateThread *thread = &threads[INSTRUMENT_MAX_THREADS];
+        if (free_slots_count > 0) {
+            thread = &threads[free_slots[--free_slots_count]];
+            retired.calls += thread->counters.calls;
+            retired.bytes += thread->counters.bytes;
+            retired.time += thread->counters.time;
+            memset(&thread->counters, 0, sizeof(PopulateCounters));
+            thread->generation++;
+        } else if (threads_count < INSTRUMENT_MAX_THREADS) {
+            thread = &threads[threads_count];
+            __atomic_store_n(&threads_count, threads_count + 1, __ATOMIC_RELAXED);
+        }
+        if (!thread->overflow) {
+            thread->tid = (pid_t) syscall(SYS_gettid);
+            thread->backend = backend;
+        }
+        pthread_mutex_unlock(&slots_lock);
+
+        current_thread = thread;
+        if (thread->overflow) {
+            __atomic_fetch_add(&overflowed, 1, __ATOMIC_RELAXED);
+        } else {
+            pthread_setspecific(slot_key, current_thread);
+        }
+    }
+    return current_thread;
+}
+
+size_t instrument_overflowed() {
+    return __atomic_load_n(&overflowed, __ATOMIC_RELAXED);
+}
+
+static int32_t instrumented_populate(void* user_data, uintptr_t start, uintptr_t end, unsigned char* target) {
+    InstrumentedPopulate *wrapper = (InstrumentedPopulate *) user_data;
+    uint64_t start_time = current_time_in_ns();
+    int32_t result = wrapper->populate_fn(wrapper->populate_data, start, end, target);
+    uint64_t end_time = current_time_in_ns();
+    uint64_t elapsed_time = end_time - start_time;
+    if (trace_enabled()) {
+        trace_populate(wrapper->backend, wrapper->populate_data, start, end, start_time, end_time);
+    }
+
+    PopulateThread *thread = instrument_thread(wrapper->backend);
+    __atomic_fetch_add(&thread->counters.calls, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&thread->counters.bytes, (end - start) * wrapper->element_size, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&thread->counters.time, elapsed_time, __ATOMIC_RELAXED);
+    if (wrapper->scope != NULL) {
+        __atomic_fetch_add(&wrapper->scope->calls, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&wrapper->scope->bytes, (end - start) * wrapper->element_size, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&wrapper->scope->time, elapsed_time, __ATOMIC_RELAXED);
+    }
+    return result;
+}
+
+void instrument_wrap(populate_t *populate_fn, void **populate_data, size_t element_size, const char *backend) {
+    if (!enabled) {
+        return;
+    }
+    InstrumentedPopulate *wrapper = (InstrumentedPopulate *) malloc(sizeof(InstrumentedPopulate));
+    wrapper->populate_fn = *populate_fn;
+    wrapper->populate_data = *populate_data;
+    wrapper->element_size = element_size;
+    wrapper->backend = backend;
+    wrapper->scope = scope;
+    *populate_fn = instrumented_populate;
+    *populate_data = wrapper;
+}
+
+void *instrument_data(populate_t populate_fn, void *populate_data) {
+    if (populate_fn != instrumented_populate) {
+        return populate_data;
+    }
+    return ((InstrumentedPopulate *) populate_data)->populate_data;
+}
+
+populate_t instrument_function(populate_t populate_fn, void *populate_data) {
+    if (populate_fn != instrumented_populate) {
+        return populate_fn;
+    }
+    return ((InstrumentedPopulate *) populate_data)->populate_fn;
+}
+
+void instrument_unwrap(populate_t *populate_fn, void **populate_data) {
+    if (*populate_fn != instrumented_populate) {
+        return;
+    }
+    InstrumentedPopulate *wrapper = (InstrumentedPopulate *) *populate_data;
+    *populate_fn = wrapper->populate_fn;
+    *populate_data = wrapper->populate_data;
+    free(wrapper);
+}
+
+static void instrument_copy(PopulateThread *target, PopulateThread *source) {
+    target->tid = source->tid;
+    target->backend = source->backend;
+    target->generation = source->generation;
+    target->overflow = source->overflow;
+    target->counters.calls = __atomic_load_n(&source->counters.calls, __ATOMIC_RELAXED);
+    target->counters.bytes = __atomic_load_n(&source->counters.bytes, __ATOMIC_RELAXED);
+    target->counters.time = __atomic_load_n(&source->counters.time, __ATOMIC_RELAXED);
+}
+
+void instrument_totals(PopulateCounters *totals) {
+    pthread_mutex_lock(&slots_lock);
+    *totals = retired;
+    for (size_t i = 0; i < threads_count; i++) {
+        totals->calls += __atomic_load_n(&threads[i].counters.calls, __ATOMIC_RELAXED);
+        totals->bytes += __atomic_load_n(&threads[i].counters.bytes, __ATOMIC_RELAXED);
+        totals->time += __atomic_load_n(&threads[i].counters.time, __ATOMIC_RELAXED);
+    }
+    PopulateCounters *shared = &threads[INSTRUMENT_MAX_THREADS].counters;
+    totals->calls += __atomic_load_n(&shared->calls, __ATOMIC_RELAXED);
+    totals->bytes += __atomic_load_n(&shared->bytes, __ATOMIC_RELAXED);
+    totals->time += __atomic_load_n(&shared->time, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&slots_lock);
+}
+
+size_t instrument_threads(PopulateThread *target, size_t capacity) {
+    pthread_mutex_lock(&slots_lock);
+    size_t count = 0;
+    for (size_t i = 0; i < threads_count && count < capacity; i++) {
+        instrument_copy(&target[count++], &threads[i]);
+    }
+    if (instrument_overflowed() != 0 && count < capacity) {
+        instrument_copy(&target[count++], &threads[INSTRUMENT_MAX_THREADS]);
+    }
+    pthread_mutex_unlock(&slots_lock);
+    return count;
+}
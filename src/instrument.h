@@ -0,0 +1,91 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+// Populate-callback instrumentation. Any populate_fn/populate_data pair can
+// be wrapped before it is handed to UFO, New York, or Toronto; the wrapper
+// counts calls, bytes produced, and nanoseconds spent inside the callback,
+// separately for every thread that calls it. Wrapping is a no-op unless
+// instrumentation was enabled before the object was created.
+
+typedef int32_t (*populate_t)(void* user_data, uintptr_t start, uintptr_t end, unsigned char* target);
+
+#define INSTRUMENT_MAX_THREADS 256
+
+typedef struct {
+    uint64_t calls;
+    uint64_t bytes;
+    uint64_t time;   // Nanoseconds.
+} PopulateCounters;
+
+// Counters of one thread that ran at least one populate callback, or of
+// all threads that found every slot taken.
+typedef struct {
+    pid_t tid;              // 0 for the overflow slot.
+    const char *backend;    // "overflow" for the overflow slot.
+    uint64_t generation;    // Bumped every time the slot passes to a new thread.
+    bool overflow;
+    PopulateCounters counters;
+} PopulateThread;
+
+void instrument_enable(bool enabled);
+bool instrument_enabled();
+
+// Replaces the pair with the wrapper in place.
+void instrument_wrap(populate_t *populate_fn, void **populate_data, size_t element_size, const char *backend);
+
+// Returns the wrapped populate_data, or populate_data itself if the pair is
+// not a wrapper. Does not free anything.
+void *instrument_data(populate_t populate_fn, void *populate_data);
+
+// Returns the wrapped populate_fn, or populate_fn itself if the pair is not
+// a wrapper.
+populate_t instrument_function(populate_t populate_fn, void *populate_data);
+
+// Restores the original pair in place and frees the wrapper.
+void instrument_unwrap(populate_t *populate_fn, void **populate_data);
+
+// Populate calls of objects wrapped while `counters` is set are also
+// counted there, whichever thread runs them. NULL stops attributing newly
+// wrapped objects. The counters must outlive the objects.
+void instrument_scope(PopulateCounters *counters);
+
+// Sum over all threads, including those that exited.
+void instrument_totals(PopulateCounters *totals);
+
+// Copies out at most `capacity` rows, one per slot in slot order followed by
+// the overflow slot if anything was counted there, and returns how many.
+// A slot is reused once its thread exits and then counts from zero under the
+// new thread's tid and the next generation; the exited thread's counts only
+// remain in the totals. INSTRUMENT_MAX_THREADS + 1 rows always suffice.
+size_t instrument_threads(PopulateThread *threads, size_t capacity);
+
+// How many threads so far found every slot taken and were counted with the
+// overflow slot.
+size_t instrument_overflowed();
+
+// Work on the populate_fn/populate_data fields of UfoParameters,
+// BoroughParameters or VillageParameters.
+#define INSTRUMENT_PARAMETERS(parameters, backend) do {                          \
+    populate_t populate_fn = (populate_t) (parameters).populate_fn;               \
+    void *populate_data = (parameters).populate_data;                             \
+    instrument_wrap(&populate_fn, &populate_data, (parameters).element_size, backend); \
+    (parameters).populate_fn = populate_fn;                                       \
+    (parameters).populate_data = populate_data;                                   \
+} while (0)
+
+#define UNINSTRUMENT_PARAMETERS(parameters) do {                                  \
+    populate_t populate_fn = (populate_t) (parameters).populate_fn;               \
+    void *populate_data = (parameters).populate_data;                             \
+    instrument_unwrap(&populate_fn, &populate_data);                              \
+    (parameters).populate_fn = populate_fn;                                       \
+    (parameters).populate_data = populate_data;                                   \
+} while (0)
+
+#define INSTRUMENTED_DATA(parameters) \
+    instrument_data((populate_t) (parameters).populate_fn, (parameters).populate_data)
+
+#define INSTRUMENTED_FUNCTION(parameters) \
+    instrument_function((populate_t) (parameters).populate_fn, (parameters).populate_data)
@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include "logging.h"
+#include "memory.h"
+
+// Reads a "Key:   1234 kB" line out of /proc/self/status, in bytes.
+static size_t proc_status_field(char *contents, const char *key) {
+    char *line = strstr(contents, key);
+    if (line == NULL) {
+        return 0;
+    }
+    return (size_t) strtoul(line + strlen(key), NULL, 10) * 1024;
+}
+
+// Whatever cannot be read stays zero.
+void MemoryStats_now(MemoryStats *stats) {
+    memset(stats, 0, sizeof(MemoryStats));
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        stats->minor_faults = (uint64_t) usage.ru_minflt;
+        stats->major_faults = (uint64_t) usage.ru_majflt;
+    }
+
+    FILE *file = fopen("/proc/self/status", "r");
+    if (file == NULL) {
+        WARN("Cannot read /proc/self/status, memory sizes will be zero\n");
+        return;
+    }
+    char contents[4096];
+    size_t length = fread(contents, sizeof(char), sizeof(contents) - 1, file);
+    contents[length] = '\0';
+    fclose(file);
+
+    stats->rss = proc_status_field(contents, "VmRSS:");
+    stats->hwm = proc_status_field(contents, "VmHWM:");
+    stats->swap = proc_status_field(contents, "VmSwap:");
+
+    file = fopen("/proc/self/io", "r");
+    if (file == NULL) {
+        return;
+    }
+    length = fread(contents, sizeof(char), sizeof(contents) - 1, file);
+    contents[length] = '\0';
+    fclose(file);
+
+    char *line = strstr(contents, "wchar:");
+    if (line != NULL) {
+        stats->written = strtoull(line + strlen("wchar:"), NULL, 10);
+    }
+    line = strstr(contents, "\nwrite_bytes:");
+    if (line != NULL) {
+        stats->storage_written = strtoull(line + strlen("\nwrite_bytes:"), NULL, 10);
+    }
+}
+
+size_t memory_rss() {
+    FILE *file = fopen("/proc/self/statm", "r");
+    if (file == NULL) {
+        return 0;
+    }
+    unsigned long size = 0, resident = 0;
+    int read = fscanf(file, "%lu %lu", &size, &resident);
+    fclose(file);
+    if (read != 2) {
+        return 0;
+    }
+    return (size_t) resident * (size_t) sysconf(_SC_PAGESIZE);
+}
+
+static void MemorySampler_sample(MemorySampler *sampler) {
+    size_t rss = memory_rss();
+    sampler->samples++;
+    sampler->total_rss += (double) rss;
+    if (rss > sampler->peak_rss) {
+        sampler->peak_rss = rss;
+    }
+}
+
+static void *MemorySampler_run(void *argument) {
+    MemorySampler *sampler = (MemorySampler *) argument;
+    struct timespec interval;
+    interval.tv_sec = sampler->interval / 1000000000;
+    interval.tv_nsec = sampler->interval % 1000000000;
+    while (sampler->running) {
+        nanosleep(&interval, NULL);
+        MemorySampler_sample(sampler);
+    }
+    return NULL;
+}
+
+void MemorySampler_start(MemorySampler *sampler, uint64_t interval) {
+    sampler->interval = interval;
+    sampler->samples = 0;
+    sampler->peak_rss = 0;
+    sampler->total_rss = 0;
+    sampler->running = true;
+    MemorySampler_sample(sampler);
+    if (interval == 0) {
+        sampler->running = false;
+        return;
+    }
+    if (0 != pthread_create(&sampler->thread, NULL, MemorySampler_run, sampler)) {
+        WARN("Cannot start memory sampler thread, only sampling at start and stop\n");
+        sampler->running = false;
+    }
+}
+
+void MemorySampler_stop(MemorySampler *sampler) {
+    if (sampler->running) {
+        sampler->running = false;
+        pthread_join(sampler->thread, NULL);
+    }
+    MemorySampler_sample(sampler);
+}
+
+size_t MemorySampler_average_rss(MemorySampler *sampler) {
+    return sampler->samples == 0 ? 0 : (size_t) (sampler->total_rss / (double) sampler->samples);
+}
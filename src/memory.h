@@ -0,0 +1,41 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+// Process-wide memory counters at a single point in time. Fault counts come
+// from getrusage and cover all threads, including the ones the UFO runtimes
+// use to handle faults. Sizes come from /proc/self/status and are in bytes.
+// Written bytes come from /proc/self/io: `written` counts everything passed
+// to write-like system calls (which is how the runtimes write dirty chunks
+// back), `storage_written` what actually had to go to the block layer.
+typedef struct {
+    uint64_t minor_faults;
+    uint64_t major_faults;
+    size_t rss;
+    size_t hwm;
+    size_t swap;
+    uint64_t written;
+    uint64_t storage_written;
+} MemoryStats;
+
+void MemoryStats_now(MemoryStats *stats);
+
+// Resident set size in bytes, read from /proc/self/statm (cheaper than
+// parsing /proc/self/status).
+size_t memory_rss();
+
+// Background thread that polls the resident set size at a fixed interval.
+typedef struct {
+    pthread_t thread;
+    uint64_t interval;    // Nanoseconds between samples.
+    volatile bool running;
+    size_t samples;
+    size_t peak_rss;
+    double total_rss;
+} MemorySampler;
+
+void MemorySampler_start(MemorySampler *sampler, uint64_t interval);
+void MemorySampler_stop(MemorySampler *sampler);
+size_t MemorySampler_average_rss(MemorySampler *sampler);
@@ -6,6 +6,7 @@
 #include <sys/mman.h>
 
 #include "logging.h"
+#include "instrument.h"
 
 typedef struct {
     char *source;
@@ -65,6 +66,7 @@ MMap *MMap_ufo_new(UfoCore *ufo_system, char *filename, char_map_t map_f, bool r
     parameters.read_only = read_only;
     parameters.populate_data = mmap;
     parameters.populate_fn = mmap_populate;
+    INSTRUMENT_PARAMETERS(parameters, "ufo");
 
     UfoObj ufo_object = ufo_new_object(ufo_system, &parameters);
     if (ufo_is_error(&ufo_object)) {
@@ -93,6 +95,7 @@ void MMap_ufo_free(UfoCore *ufo_system, MMap *mmap_object) {
         return;
     }
     
+    UNINSTRUMENT_PARAMETERS(parameters);
     MMapData *mmap = (MMapData *) parameters.populate_data;
     munmap(mmap->source, mmap->size);    
     free(mmap);
@@ -148,6 +151,7 @@ Borough *MMap_nyc_new(NycCore *system, char *filename, char_map_t map_f, size_t
     parameters.min_load_ct = min_load_count;
     parameters.populate_data = mmap;
     parameters.populate_fn = mmap_populate;
+    INSTRUMENT_PARAMETERS(parameters, "nyc");
 
     Borough *object = (Borough *) malloc(sizeof(Borough));
     *object = nyc_new_borough(system, &parameters);
@@ -163,6 +167,7 @@ void MMap_nyc_free(NycCore *system, Borough *object) {
     BoroughParameters parameters;
     borough_params(object, &parameters);
     
+    UNINSTRUMENT_PARAMETERS(parameters);
     MMapData *mmap = (MMapData *) parameters.populate_data;
     munmap(mmap->source, mmap->size);    
     free(mmap);    
@@ -191,6 +196,7 @@ Village *MMap_toronto_new(TorontoCore *system, char *filename, char_map_t map_f,
     parameters.min_load_ct = min_load_count;
     parameters.populate_data = mmap;
     parameters.populate_fn = mmap_populate;
+    INSTRUMENT_PARAMETERS(parameters, "toronto");
 
     Village *object = (Village *) malloc(sizeof(Village));
     *object = toronto_new_village(system, &parameters);
@@ -206,6 +212,7 @@ void MMap_toronto_free(TorontoCore *system, Village *object) {
     VillageParameters parameters;
     village_params(object, &parameters);
     
+    UNINSTRUMENT_PARAMETERS(parameters);
     MMapData *mmap = (MMapData *) parameters.populate_data;
     munmap(mmap->source, mmap->size);    
     free(mmap);    
@@ -0,0 +1,269 @@
+#include "mmapfile.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <bzlib.h>
+
+#include "seq.h"
+#include "fib.h"
+#include "bzip.h"
+#include "mmap.h"
+#include "postgres.h"
+#include "col.h"
+
+#include "logging.h"
+
+#define MMAPFILE_BUFFER_SIZE (1 * MB)
+
+// Creates an anonymous file in the directory: it is unlinked right away, so
+// it disappears with its last mapping, even if the benchmark dies.
+static int mmapfile_open(const char *directory) {
+    char path[PATH_MAX];
+    if (snprintf(path, sizeof(path), "%s/ufo-bench-XXXXXX", directory) >= (int) sizeof(path)) {
+        REPORT("Temporary file path in \"%s\" is too long\n", directory);
+        return -1;
+    }
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        REPORT("Cannot create a temporary file in \"%s\" (%s)\n", directory, strerror(errno));
+        return -1;
+    }
+    unlink(path);
+    return fd;
+}
+
+// Maps the first size bytes of the file shared, growing the file if needed.
+// Closes the file either way, the mapping keeps it open.
+static void *mmapfile_map(int fd, size_t size) {
+    if (size == 0 || ftruncate(fd, size) != 0) {
+        REPORT("Cannot size a temporary file to %lu bytes (%s)\n", size, strerror(errno));
+        close(fd);
+        return NULL;
+    }
+    void *data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        REPORT("Cannot map a temporary file of %lu bytes (%s)\n", size, strerror(errno));
+        return NULL;
+    }
+    return data;
+}
+
+static void *mmapfile_new(const char *directory, size_t size) {
+    int fd = mmapfile_open(directory);
+    if (fd < 0) {
+        return NULL;
+    }
+    return mmapfile_map(fd, size);
+}
+
+// Creation writes the file back in full, so execution starts from clean
+// pages in the page cache and only pays for writeback of its own writes.
+static void *mmapfile_commit(void *data, size_t size) {
+    if (data != NULL && msync(data, size, MS_SYNC) != 0) {
+        WARN("Cannot write back a temporary file of %lu bytes (%s)\n", size, strerror(errno));
+    }
+    return data;
+}
+
+static void mmapfile_free(void *data, size_t size) {
+    if (data != NULL) {
+        munmap(data, size);
+    }
+}
+
+void *mmapfile_setup(Arguments *config) {
+    if (access(config->mmapfile_directory, W_OK) != 0) {
+        REPORT("Cannot write temporary files to \"%s\" (%s)\n", config->mmapfile_directory, strerror(errno));
+        exit(1);
+    }
+    return (void *) config->mmapfile_directory;
+}
+
+void mmapfile_teardown(Arguments *config, AnySystem system) {
+    /* empty */
+}
+
+// Fib
+void *mmapfile_fib_creation(Arguments *config, AnySystem system) {
+    size_t n = config->size;
+    uint64_t *target = (uint64_t *) mmapfile_new((char *) system, sizeof(uint64_t) * n);
+    if (target == NULL) {
+        return NULL;
+    }
+    for (size_t i = 0; i < n; i++) {
+        target[i] = i < 2 ? 1 : target[i - 1] + target[i - 2];
+    }
+    return mmapfile_commit(target, sizeof(uint64_t) * n);
+}
+void mmapfile_fib_cleanup(Arguments *config, AnySystem system, AnyObject object) {
+    mmapfile_free(object, sizeof(uint64_t) * config->size);
+}
+
+// Bzip
+// Decompresses through a small buffer straight into the file, rather than
+// into a buffer the size of the output.
+void *mmapfile_bzip_creation(Arguments *config, AnySystem system) {
+    FILE *stream = fopen(config->file, "r");
+    if (!stream) {
+        REPORT("Cannot read file \"%s\"\n", config->file);
+        return NULL;
+    }
+
+    int error;
+    BZFILE *bzip2_stream = BZ2_bzReadOpen(&error, stream, 0, 0, NULL, 0);
+    if (error != BZ_OK) {
+        BZ2_bzReadClose(&error, bzip2_stream);
+        fclose(stream);
+        REPORT("Cannot process file \"%s\"\n", config->file);
+        return NULL;
+    }
+
+    int fd = mmapfile_open((char *) system);
+    if (fd < 0) {
+        BZ2_bzReadClose(&error, bzip2_stream);
+        fclose(stream);
+        return NULL;
+    }
+
+    char *buffer = (char *) malloc(sizeof(char) * MMAPFILE_BUFFER_SIZE);
+    size_t size = 0;
+    error = BZ_OK;
+    while (error == BZ_OK) {
+        int read_bytes = BZ2_bzRead(&error, bzip2_stream, buffer, MMAPFILE_BUFFER_SIZE);
+        if ((error != BZ_OK && error != BZ_STREAM_END) || read_bytes <= 0) {
+            continue;
+        }
+        if (write(fd, buffer, read_bytes) != read_bytes) {
+            REPORT("Cannot write a temporary file (%s)\n", strerror(errno));
+            error = BZ_IO_ERROR;
+        }
+        size += read_bytes;
+    }
+    free(buffer);
+
+    int close_error;
+    BZ2_bzReadClose(&close_error, bzip2_stream);
+    fclose(stream);
+    if (error != BZ_STREAM_END) {
+        REPORT("Cannot decompress file \"%s\"\n", config->file);
+        close(fd);
+        return NULL;
+    }
+
+    char *data = (char *) mmapfile_map(fd, size);
+    if (data == NULL) {
+        return NULL;
+    }
+    BZip2 *bzip = (BZip2 *) malloc(sizeof(BZip2));
+    bzip->data = (char *) mmapfile_commit(data, size);
+    bzip->size = size;
+    return (void *) bzip;
+}
+void mmapfile_bzip_cleanup(Arguments *config, AnySystem system, AnyObject object) {
+    BZip2 *bzip = (BZip2 *) object;
+    mmapfile_free(bzip->data, bzip->size);
+    free(bzip);
+}
+
+// Seq
+void *mmapfile_seq_creation(Arguments *config, AnySystem system) {
+    Seq data;
+    data.from = 1;
+    data.by = 2;
+    data.length = config->size;
+    data.to = (data.length - 1) * data.by + data.from;
+
+    int64_t *target = (int64_t *) mmapfile_new((char *) system, sizeof(int64_t) * data.length);
+    if (target == NULL) {
+        return NULL;
+    }
+    seq_populate(&data, 0, data.length, (unsigned char *) target);
+    return mmapfile_commit(target, sizeof(int64_t) * data.length);
+}
+void mmapfile_seq_cleanup(Arguments *config, AnySystem system, AnyObject object) {
+    mmapfile_free(object, sizeof(int64_t) * config->size);
+}
+
+// Psql
+// The rows come from the database one by one, so they are collected in
+// memory first and the file is written in one go.
+void *mmapfile_psql_creation(Arguments *config, AnySystem system) {
+    Players *source = Players_normil_new();
+    if (source == NULL) {
+        return NULL;
+    }
+    Player *data = (Player *) mmapfile_new((char *) system, sizeof(Player) * source->size);
+    if (data == NULL) {
+        Players_normil_free(source);
+        return NULL;
+    }
+    memcpy(data, source->data, sizeof(Player) * source->size);
+
+    Players *players = (Players *) malloc(sizeof(Players));
+    players->size = source->size;
+    players->data = (Player *) mmapfile_commit(data, sizeof(Player) * source->size);
+    Players_normil_free(source);
+    return (void *) players;
+}
+void mmapfile_psql_cleanup(Arguments *config, AnySystem system, AnyObject object) {
+    Players *players = (Players *) object;
+    mmapfile_free(players->data, sizeof(Player) * players->size);
+    free(players);
+}
+
+// MMap
+void *mmapfile_mmap_creation(Arguments *config, AnySystem system) {
+    size_t size;
+    char *source = mmap_new(config->file, &size);
+    if (source == NULL) {
+        perror("ERROR");
+        REPORT("Cannot open file %s\n", config->file);
+        return NULL;
+    }
+    char *data = (char *) mmapfile_new((char *) system, size);
+    if (data == NULL) {
+        munmap(source, size);
+        return NULL;
+    }
+    for (size_t i = 0; i < size; i++) {
+        data[i] = toupper(source[i]);
+    }
+    munmap(source, size);
+
+    MMap *mmap_object = (MMap *) malloc(sizeof(MMap));
+    mmap_object->data = (char *) mmapfile_commit(data, size);
+    mmap_object->size = size;
+    return (void *) mmap_object;
+}
+void mmapfile_mmap_cleanup(Arguments *config, AnySystem system, AnyObject object) {
+    MMap *mmap_object = (MMap *) object;
+    mmapfile_free(mmap_object->data, mmap_object->size);
+    free(mmap_object);
+}
+
+// Col
+void *mmapfile_col_creation(Arguments *config, AnySystem system) {
+    int32_t **matrix = col_source_matrix_new(config->size, COL_COLUMNS_IN_EACH_ROW);
+    ColumnSpec data;
+    data.column = COL_SELECTED_COLUMN;
+    data.size = config->size;
+    data.source = matrix;
+
+    int32_t *target = (int32_t *) mmapfile_new((char *) system, sizeof(int32_t) * data.size);
+    if (target != NULL) {
+        col_populate(&data, 0, data.size, (unsigned char *) target);
+        mmapfile_commit(target, sizeof(int32_t) * data.size);
+    }
+    col_source_matrix_free(matrix, config->size);
+    return (void *) target;
+}
+void mmapfile_col_cleanup(Arguments *config, AnySystem system, AnyObject object) {
+    mmapfile_free(object, sizeof(int32_t) * config->size);
+}
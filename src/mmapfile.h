@@ -0,0 +1,24 @@
+#pragma once
+
+#include "bench.h"
+
+// The mmapfile implementation writes the whole object out up front, like
+// normil, but into a temporary file in --mmapfile-dir that is mapped shared,
+// so it is the kernel that pages the data in and out of the page cache.
+
+void *mmapfile_setup(Arguments *config);
+void mmapfile_teardown(Arguments *config, AnySystem system);
+
+void *mmapfile_fib_creation(Arguments *config, AnySystem system);
+void *mmapfile_bzip_creation(Arguments *config, AnySystem system);
+void *mmapfile_seq_creation(Arguments *config, AnySystem system);
+void *mmapfile_psql_creation(Arguments *config, AnySystem system);
+void *mmapfile_mmap_creation(Arguments *config, AnySystem system);
+void *mmapfile_col_creation(Arguments *config, AnySystem system);
+
+void mmapfile_fib_cleanup(Arguments *config, AnySystem system, AnyObject object);
+void mmapfile_bzip_cleanup(Arguments *config, AnySystem system, AnyObject object);
+void mmapfile_seq_cleanup(Arguments *config, AnySystem system, AnyObject object);
+void mmapfile_psql_cleanup(Arguments *config, AnySystem system, AnyObject object);
+void mmapfile_mmap_cleanup(Arguments *config, AnySystem system, AnyObject object);
+void mmapfile_col_cleanup(Arguments *config, AnySystem system, AnyObject object);
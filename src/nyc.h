@@ -20,9 +20,9 @@ void ny_psql_cleanup(Arguments *config, AnySystem system, AnyObject object);
 void ny_mmap_cleanup(Arguments *config, AnySystem system, AnyObject object);
 void ny_col_cleanup(Arguments *config, AnySystem system, AnyObject object);
 
-void ny_fib_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette);
-void ny_bzip_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette);
-void ny_seq_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette);
-void ny_psql_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette);
-void ny_mmap_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette);
-void ny_col_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette);
\ No newline at end of file
+void ny_fib_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette);
+void ny_bzip_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette);
+void ny_seq_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette);
+void ny_psql_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette);
+void ny_mmap_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette);
+void ny_col_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette);
\ No newline at end of file
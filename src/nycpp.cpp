@@ -7,6 +7,7 @@ extern "C" {
 #endif
 
 #include "random.h"
+#include "timing.h"
 #include "logging.h"
 
 #include "seq.h"
@@ -40,21 +41,26 @@ void nycpp_seq_cleanup(Arguments *config, AnySystem system, AnyObject object) {
     delete nycpp;
 }
 
-void nycpp_seq_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette) {
+void nycpp_seq_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
     int64_t *data = (int64_t *) object;    
     int64_t sum = 0;
-    SequenceResult result;
-    while (true) {
-        result = next(config, sequence);        
-        if (result.end) {
-            break;
-        }        
-        if (result.write) {
-            data[result.current] = random_int(1000);
-        } else {
-            sum += data[result.current];
+    SequenceBatch batch;
+    while (next(config, sequence, &batch) > 0) {
+        for (size_t i = 0; i < batch.length; i++) {
+            uint64_t start_time = Histogram_tick(latencies) ? current_time_in_ns() : 0;
+            if (batch.access[i] == ACCESS_READ) {
+                sum += data[batch.current[i]];
+            } else if (batch.access[i] == ACCESS_WRITE) {
+                data[batch.current[i]] = random_int(1000);
+            } else {
+                sum += data[batch.current[i]];
+                data[batch.current[i]] += 1;
+            }
+            if (start_time != 0) {
+                Histogram_record(latencies, current_time_in_ns() - start_time);
+            }
         }
-    };
+    }
     *oubliette = sum;
 }
 
@@ -68,21 +74,26 @@ void nycpp_fib_cleanup(Arguments *config, AnySystem system, AnyObject object) {
     NYCpp<uint64_t> *nycpp = (NYCpp<uint64_t> *) object;
     delete nycpp;
 }
-void nycpp_fib_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette) {
+void nycpp_fib_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
     uint64_t *data = (uint64_t *) object;    
     uint64_t sum = 0;
-    SequenceResult result;
-    while (true) {
-        result = next(config, sequence);        
-        if (result.end) {
-            break;
+    SequenceBatch batch;
+    while (next(config, sequence, &batch) > 0) {
+        for (size_t i = 0; i < batch.length; i++) {
+            uint64_t start_time = Histogram_tick(latencies) ? current_time_in_ns() : 0;
+            if (batch.access[i] == ACCESS_READ) {
+                sum += data[batch.current[i]];
+            } else if (batch.access[i] == ACCESS_WRITE) {
+                data[batch.current[i]] = random_int(1000);
+            } else {
+                sum += data[batch.current[i]];
+                data[batch.current[i]] += 1;
+            }
+            if (start_time != 0) {
+                Histogram_record(latencies, current_time_in_ns() - start_time);
+            }
         }
-        if (result.write) {
-            data[result.current] = random_int(1000);
-        } else {
-            sum += data[result.current];
-        }
-    };
+    }
     *oubliette = sum;
 }
 
@@ -97,21 +108,26 @@ void nycpp_bzip_cleanup(Arguments *config, AnySystem system, AnyObject object) {
     NYCpp<char> *nycpp = (NYCpp<char> *) object;
     delete nycpp;
 }
-void nycpp_bzip_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette) {
+void nycpp_bzip_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
     NYCpp<char> *nycpp = (NYCpp<char> *) object;    
     uint64_t sum = 0;
-    SequenceResult result;
-    while (true) {
-        result = next(config, sequence);        
-        if (result.end) {
-            break;
-        }        
-        if (result.write) {
-            (*nycpp)[result.current] = random_int(126 - 32) + 32;
-        } else {
-            sum += (*nycpp)[result.current];
+    SequenceBatch batch;
+    while (next(config, sequence, &batch) > 0) {
+        for (size_t i = 0; i < batch.length; i++) {
+            uint64_t start_time = Histogram_tick(latencies) ? current_time_in_ns() : 0;
+            if (batch.access[i] == ACCESS_READ) {
+                sum += (*nycpp)[batch.current[i]];
+            } else if (batch.access[i] == ACCESS_WRITE) {
+                (*nycpp)[batch.current[i]] = random_int(126 - 32) + 32;
+            } else {
+                sum += (*nycpp)[batch.current[i]];
+                (*nycpp)[batch.current[i]] += 1;
+            }
+            if (start_time != 0) {
+                Histogram_record(latencies, current_time_in_ns() - start_time);
+            }
         }
-    };
+    }
     *oubliette = sum;
 }
 
@@ -126,24 +142,31 @@ void nycpp_psql_cleanup(Arguments *config, AnySystem system, AnyObject object) {
     NYCpp<Player> *nycpp = (NYCpp<Player> *) object;
     delete nycpp;
 }
-void nycpp_psql_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette) {
+void nycpp_psql_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
     NYCpp<Player> *nycpp = (NYCpp<Player> *) object;    
     int64_t tds = 0;
     int64_t mvp = 0;
-    SequenceResult result;
-    while (true) {
-        result = next(config, sequence);        
-        if (result.end) {
-            break;
-        }        
-        if (result.write) {
-            (*nycpp)[result.current].tds = random_int(100);
-            (*nycpp)[result.current].mvp = random_int(100);
-        } else {
-            tds += (*nycpp)[result.current].tds;
-            mvp += (*nycpp)[result.current].mvp;
+    SequenceBatch batch;
+    while (next(config, sequence, &batch) > 0) {
+        for (size_t i = 0; i < batch.length; i++) {
+            uint64_t start_time = Histogram_tick(latencies) ? current_time_in_ns() : 0;
+            if (batch.access[i] == ACCESS_READ) {
+                tds += (*nycpp)[batch.current[i]].tds;
+                mvp += (*nycpp)[batch.current[i]].mvp;
+            } else if (batch.access[i] == ACCESS_WRITE) {
+                (*nycpp)[batch.current[i]].tds = random_int(100);
+                (*nycpp)[batch.current[i]].mvp = random_int(100);
+            } else {
+                tds += (*nycpp)[batch.current[i]].tds;
+                mvp += (*nycpp)[batch.current[i]].mvp;
+                (*nycpp)[batch.current[i]].tds += 1;
+                (*nycpp)[batch.current[i]].mvp += 1;
+            }
+            if (start_time != 0) {
+                Histogram_record(latencies, current_time_in_ns() - start_time);
+            }
         }
-    };
+    }
     *oubliette = tds + mvp;
 }
 
@@ -158,21 +181,26 @@ void nycpp_mmap_cleanup(Arguments *config, AnySystem system, AnyObject object) {
     NYCpp<char> *nycpp = (NYCpp<char> *) object;
     delete nycpp;
 }
-void nycpp_mmap_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette) {
+void nycpp_mmap_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
     NYCpp<char> *nycpp = (NYCpp<char> *) object;    
     uint64_t sum = 0;
-    SequenceResult result;
-    while (true) {
-        result = next(config, sequence);        
-        if (result.end) {
-            break;
-        }        
-        if (result.write) {
-            (*nycpp)[result.current] = random_int(126 - 32) + 32;
-        } else {
-            sum += (*nycpp)[result.current];
+    SequenceBatch batch;
+    while (next(config, sequence, &batch) > 0) {
+        for (size_t i = 0; i < batch.length; i++) {
+            uint64_t start_time = Histogram_tick(latencies) ? current_time_in_ns() : 0;
+            if (batch.access[i] == ACCESS_READ) {
+                sum += (*nycpp)[batch.current[i]];
+            } else if (batch.access[i] == ACCESS_WRITE) {
+                (*nycpp)[batch.current[i]] = random_int(126 - 32) + 32;
+            } else {
+                sum += (*nycpp)[batch.current[i]];
+                (*nycpp)[batch.current[i]] += 1;
+            }
+            if (start_time != 0) {
+                Histogram_record(latencies, current_time_in_ns() - start_time);
+            }
         }
-    };
+    }
     *oubliette = sum;
 }
 
@@ -185,7 +213,7 @@ void nycpp_col_cleanup(Arguments *config, AnySystem system, AnyObject object) {
     REPORT("UNIMPLEMENTED!\n");
     exit(99);
 }
-void nycpp_col_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette) {
+void nycpp_col_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
     REPORT("UNIMPLEMENTED!\n");
     exit(99);
 }
\ No newline at end of file
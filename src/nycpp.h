@@ -59,13 +59,13 @@ void  nycpp_psql_cleanup  (Arguments *config, AnySystem system, AnyObject object
 void  nycpp_mmap_cleanup  (Arguments *config, AnySystem system, AnyObject object);
 void  nycpp_col_cleanup   (Arguments *config, AnySystem system, AnyObject object);
 
-void  nycpp_seq_execution (Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette);
-void  nycpp_fib_execution (Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette);
-void  nycpp_bzip_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette);
-void  nycpp_seq_execution (Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette);
-void  nycpp_psql_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette);
-void  nycpp_mmap_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette);
-void  nycpp_col_execution (Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette);
+void  nycpp_seq_execution (Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette);
+void  nycpp_fib_execution (Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette);
+void  nycpp_bzip_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette);
+void  nycpp_seq_execution (Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette);
+void  nycpp_psql_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette);
+void  nycpp_mmap_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette);
+void  nycpp_col_execution (Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,79 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "pagecache.h"
+
+bool page_cache_evict(const char *path, bool drop, bool *dropped) {
+    *dropped = false;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    // Dirty pages are not evicted, so write them back first.
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+
+    if (drop) {
+        sync();
+        FILE *file = fopen("/proc/sys/vm/drop_caches", "w");
+        if (file != NULL) {
+            bool written = fputs("1", file) >= 0;
+            *dropped = fclose(file) == 0 && written;
+        }
+    }
+    return true;
+}
+
+bool page_cache_warm(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    size_t size = 1 << 20;
+    char *buffer = (char *) malloc(size);
+    ssize_t length;
+    while ((length = read(fd, buffer, size)) > 0);
+    free(buffer);
+    close(fd);
+    return length == 0;
+}
+
+size_t page_cache_resident(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+    size_t size = (size_t) status.st_size;
+    void *mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return 0;
+    }
+
+    size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+    size_t pages = (size + page_size - 1) / page_size;
+    unsigned char *residency = (unsigned char *) malloc(pages);
+    size_t resident = 0;
+    if (mincore(mapping, size, residency) == 0) {
+        for (size_t i = 0; i < pages; i++) {
+            resident += residency[i] & 1;
+        }
+    }
+    free(residency);
+    munmap(mapping, size);
+
+    resident *= page_size;
+    return resident > size ? size : resident;
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <stddef.h>
+#include <stdbool.h>
+
+// Page cache state of an input file. Benchmarks that read a file are
+// storage-bound when it is cold and memory-bound when it is warm, so the
+// state is set up explicitly before objects are created.
+
+// Writes back and evicts the file's pages with posix_fadvise(DONTNEED).
+// Pages mapped by other processes stay. If `drop` is set, also drops the
+// whole page cache through /proc/sys/vm/drop_caches, which needs root, and
+// sets `dropped` to whether that worked. Returns false if the file cannot
+// be opened.
+bool page_cache_evict(const char *path, bool drop, bool *dropped);
+
+// Reads the whole file, so that it is in the page cache. Returns false if
+// the file cannot be read.
+bool page_cache_warm(const char *path);
+
+// Bytes of the file currently in the page cache, as reported by mincore.
+size_t page_cache_resident(const char *path);
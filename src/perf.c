@@ -0,0 +1,246 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "logging.h"
+#include "perf.h"
+
+const char *perf_counter_names[PERF_COUNTERS] = {
+    "task_clock",
+    "page_faults",
+    "context_switches",
+    "cpu_migrations",
+    "cycles",
+    "instructions",
+    "cache_misses",
+    "dtlb_misses",
+};
+
+static const struct { uint32_t type; uint64_t config; } perf_counter_events[PERF_COUNTERS] = {
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK },
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES },
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB 
+                          | (PERF_COUNT_HW_CACHE_OP_READ << 8) 
+                          | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+};
+
+// Counts one thread, on any cpu. 0 is the calling thread.
+static int perf_event_open(PerfCounter counter, pid_t tid, bool exclude_kernel) {
+    struct perf_event_attr attributes;
+    memset(&attributes, 0, sizeof(struct perf_event_attr));
+    attributes.size = sizeof(struct perf_event_attr);
+    attributes.type = perf_counter_events[counter].type;
+    attributes.config = perf_counter_events[counter].config;
+    attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attributes.exclude_hv = 1;
+    attributes.exclude_kernel = exclude_kernel;
+    return (int) syscall(SYS_perf_event_open, &attributes, tid, -1 /* any cpu */, -1, PERF_FLAG_FD_CLOEXEC);
+}
+
+void PerfCounters_init(PerfCounters *counters) {
+    memset(counters, 0, sizeof(PerfCounters));
+    for (PerfCounter counter = 0; counter < PERF_COUNTERS; counter++) {
+        counters->fds[counter] = -1;
+    }
+    pthread_mutex_init(&counters->lock, NULL);
+}
+
+int PerfCounters_open(PerfCounters *counters) {
+    int opened = 0;
+    for (PerfCounter counter = 0; counter < PERF_COUNTERS; counter++) {
+        // Counting kernel time usually needs perf_event_paranoid < 2, so fall
+        // back to user-space only.
+        int fd = perf_event_open(counter, 0, false);
+        counters->exclude_kernel[counter] = false;
+        if (fd < 0 && (errno == EACCES || errno == EPERM)) {
+            fd = perf_event_open(counter, 0, true);
+            counters->exclude_kernel[counter] = true;
+        }
+        if (fd < 0) {
+            LOG("Cannot open perf counter %s: %s\n", perf_counter_names[counter], strerror(errno));
+        } else {
+            opened++;
+        }
+        counters->fds[counter] = fd;
+    }
+    if (opened < PERF_COUNTERS) {
+        WARN("Only %i of %i perf counters are available:", opened, PERF_COUNTERS);
+        for (PerfCounter counter = 0; counter < PERF_COUNTERS; counter++) {
+            if (counters->fds[counter] < 0) {
+                fprintf(stderr, " %s", perf_counter_names[counter]);
+            }
+        }
+        fprintf(stderr, " will not be reported\n");
+    }
+    return opened;
+}
+
+static bool perf_opened(PerfCounters *counters) {
+    for (PerfCounter counter = 0; counter < PERF_COUNTERS; counter++) {
+        if (counters->fds[counter] >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool perf_thread_known(PerfCounters *counters, pid_t tid) {
+    for (size_t i = 0; i < counters->threads_count; i++) {
+        if (counters->threads[i].tid == tid) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Opens the counters that are available for the thread. Call with the lock
+// held.
+static void perf_thread_open(PerfCounters *counters, pid_t tid) {
+    if (counters->threads_count == counters->threads_capacity) {
+        counters->threads_capacity = counters->threads_capacity == 0 ? 16 : counters->threads_capacity * 2;
+        counters->threads = (PerfThread *) realloc(counters->threads, sizeof(PerfThread) * counters->threads_capacity);
+    }
+    PerfThread *thread = &counters->threads[counters->threads_count++];
+    thread->tid = tid;
+    for (PerfCounter counter = 0; counter < PERF_COUNTERS; counter++) {
+        thread->fds[counter] = counters->fds[counter] < 0 ? -1 
+            : perf_event_open(counter, tid, counters->exclude_kernel[counter]);
+    }
+}
+
+static void perf_thread_close(PerfThread *thread) {
+    for (PerfCounter counter = 0; counter < PERF_COUNTERS; counter++) {
+        if (thread->fds[counter] >= 0) {
+            close(thread->fds[counter]);
+            thread->fds[counter] = -1;
+        }
+    }
+}
+
+static bool perf_value_read(int fd, PerfValue *value) {
+    return fd >= 0 && read(fd, value, sizeof(PerfValue)) == sizeof(PerfValue);
+}
+
+static void perf_value_add(PerfValue *total, PerfValue *value) {
+    total->value += value->value;
+    total->time_enabled += value->time_enabled;
+    total->time_running += value->time_running;
+}
+
+void PerfCounters_attach(PerfCounters *counters) {
+    if (!perf_opened(counters)) {
+        return;
+    }
+    pid_t tid = (pid_t) syscall(SYS_gettid);
+    pthread_mutex_lock(&counters->lock);
+    if (tid != getpid() && !perf_thread_known(counters, tid)) {
+        perf_thread_open(counters, tid);
+    }
+    pthread_mutex_unlock(&counters->lock);
+}
+
+// Opens counters for threads seen for the first time and retires those of
+// threads that are gone: their counters still hold their final counts.
+// Call with the lock held.
+static void perf_threads_update(PerfCounters *counters) {
+    DIR *directory = opendir("/proc/self/task");
+    if (directory == NULL) {
+        return;
+    }
+    pid_t main_tid = getpid();
+    struct dirent *entry;
+    while ((entry = readdir(directory)) != NULL) {
+        pid_t tid = (pid_t) atoi(entry->d_name);
+        if (tid > 0 && tid != main_tid && !perf_thread_known(counters, tid)) {
+            perf_thread_open(counters, tid);
+        }
+    }
+    closedir(directory);
+
+    for (size_t i = 0; i < counters->threads_count; ) {
+        PerfThread *thread = &counters->threads[i];
+        char path[64];
+        snprintf(path, sizeof(path), "/proc/self/task/%d", thread->tid);
+        if (access(path, F_OK) == 0) {
+            i++;
+            continue;
+        }
+        for (PerfCounter counter = 0; counter < PERF_COUNTERS; counter++) {
+            PerfValue value;
+            if (perf_value_read(thread->fds[counter], &value)) {
+                perf_value_add(&counters->retired.values[counter], &value);
+            }
+        }
+        perf_thread_close(thread);
+        counters->threads[i] = counters->threads[--counters->threads_count];
+    }
+}
+
+void PerfCounters_read(PerfCounters *counters, PerfReading *reading) {
+    memset(reading, 0, sizeof(PerfReading));
+    if (!perf_opened(counters)) {
+        return;
+    }
+    pthread_mutex_lock(&counters->lock);
+    perf_threads_update(counters);
+    for (PerfCounter counter = 0; counter < PERF_COUNTERS; counter++) {
+        if (counters->fds[counter] < 0) {
+            continue;
+        }
+        PerfValue *total = &reading->values[counter];
+        PerfValue value;
+        if (perf_value_read(counters->fds[counter], &value)) {
+            perf_value_add(total, &value);
+        }
+        for (size_t i = 0; i < counters->threads_count; i++) {
+            if (perf_value_read(counters->threads[i].fds[counter], &value)) {
+                perf_value_add(total, &value);
+            }
+        }
+        perf_value_add(total, &counters->retired.values[counter]);
+    }
+    pthread_mutex_unlock(&counters->lock);
+}
+
+void PerfCounters_close(PerfCounters *counters) {
+    pthread_mutex_lock(&counters->lock);
+    for (size_t i = 0; i < counters->threads_count; i++) {
+        perf_thread_close(&counters->threads[i]);
+    }
+    free(counters->threads);
+    counters->threads = NULL;
+    counters->threads_count = 0;
+    counters->threads_capacity = 0;
+    pthread_mutex_unlock(&counters->lock);
+    for (PerfCounter counter = 0; counter < PERF_COUNTERS; counter++) {
+        if (counters->fds[counter] >= 0) {
+            close(counters->fds[counter]);
+            counters->fds[counter] = -1;
+        }
+    }
+}
+
+bool PerfCounters_available(PerfCounters *counters, PerfCounter counter) {
+    return counters->fds[counter] >= 0;
+}
+
+uint64_t PerfReading_delta(PerfReading *before, PerfReading *after, PerfCounter counter) {
+    uint64_t value = after->values[counter].value - before->values[counter].value;
+    uint64_t enabled = after->values[counter].time_enabled - before->values[counter].time_enabled;
+    uint64_t running = after->values[counter].time_running - before->values[counter].time_running;
+    if (running == 0 || running >= enabled) {
+        return value;
+    }
+    return (uint64_t) ((double) value * ((double) enabled / (double) running));
+}
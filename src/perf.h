@@ -0,0 +1,70 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sys/types.h>
+
+// Linux perf_event counters for the whole process, kept per thread so that
+// every read sees every thread's counts up to that moment. Inherited counters
+// would only report a thread's counts once it exits, so the UFO runtimes'
+// threads, which live until system teardown, would be charged to teardown.
+// Each read first picks up threads the process started since the last one
+// (eg. the runtimes'), counting them from then on; threads that start and
+// exit between reads, like the benchmark's own workers, attach themselves
+// with PerfCounters_attach. Hardware counters are often unavailable (virtual
+// machines, perf_event_paranoid), in which case only the software counters
+// are collected.
+typedef enum {
+    PERF_TASK_CLOCK,
+    PERF_PAGE_FAULTS,
+    PERF_CONTEXT_SWITCHES,
+    PERF_CPU_MIGRATIONS,
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_CACHE_MISSES,
+    PERF_DTLB_MISSES,
+    PERF_COUNTERS,
+} PerfCounter;
+
+extern const char *perf_counter_names[PERF_COUNTERS];
+
+typedef struct {
+    uint64_t value;
+    uint64_t time_enabled;
+    uint64_t time_running;
+} PerfValue;
+
+typedef struct {
+    PerfValue values[PERF_COUNTERS];
+} PerfReading;
+
+typedef struct {
+    pid_t tid;
+    int fds[PERF_COUNTERS];
+} PerfThread;
+
+typedef struct {
+    int fds[PERF_COUNTERS];                 // The thread that opened the counters, -1 if unavailable.
+    bool exclude_kernel[PERF_COUNTERS];
+    PerfThread *threads;                    // Every other thread, as long as it runs.
+    size_t threads_count;
+    size_t threads_capacity;
+    PerfReading retired;                    // Final counts of threads that exited.
+    pthread_mutex_t lock;
+} PerfCounters;
+
+// Marks all counters as unavailable.
+void PerfCounters_init(PerfCounters *counters);
+// Returns the number of counters that could be opened.
+int PerfCounters_open(PerfCounters *counters);
+// Counts the calling thread from now on, if it is not counted yet. A no-op
+// unless the counters were opened.
+void PerfCounters_attach(PerfCounters *counters);
+void PerfCounters_read(PerfCounters *counters, PerfReading *reading);
+void PerfCounters_close(PerfCounters *counters);
+bool PerfCounters_available(PerfCounters *counters, PerfCounter counter);
+
+// Difference between two readings, scaled up if the kernel had to multiplex
+// the counter. Times are summed over threads like the counts, so the scale
+// is an average over threads.
+uint64_t PerfReading_delta(PerfReading *before, PerfReading *after, PerfCounter counter);
@@ -6,6 +6,7 @@
 #include <libpq-fe.h>
 
 #include "logging.h"
+#include "instrument.h"
 #include "postgres.h"
 #include "ufo_c/target/ufo_c.h"
 
@@ -192,6 +193,7 @@ Players *Players_ufo_new(UfoCore *ufo_system, bool read_only, size_t min_load_co
     parameters.read_only = read_only;
     parameters.populate_data = data;
     parameters.populate_fn = Player_populate;
+    INSTRUMENT_PARAMETERS(parameters, "ufo");
     
     UfoObj ufo_object = ufo_new_object(ufo_system, &parameters);
 
@@ -226,6 +228,7 @@ void Players_ufo_free(UfoCore *ufo_system, Players *players) {
         ufo_free(ufo_object);
         return;
     }
+    UNINSTRUMENT_PARAMETERS(parameters);
     Data *data = (Data *) parameters.populate_data;
 
     // Kill the DB connection
@@ -331,6 +334,7 @@ Borough *Players_nyc_new(NycCore *system, size_t min_load_count) {
     parameters.min_load_ct = min_load_count;
     parameters.populate_data = data;
     parameters.populate_fn = Player_populate;
+    INSTRUMENT_PARAMETERS(parameters, "nyc");
     
     Borough *object = (Borough *) malloc(sizeof(Borough));
     *object = nyc_new_borough(system, &parameters);
@@ -348,6 +352,7 @@ void Players_nyc_free(NycCore *system, Borough *object) {
     // Retrieve the parameters to finalize all the user objects within.
     BoroughParameters parameters;
     borough_params(object, &parameters);    
+    UNINSTRUMENT_PARAMETERS(parameters);
     Data *data = (Data *) parameters.populate_data;
 
     // Kill the DB connection
@@ -396,6 +401,7 @@ Village *Players_toronto_new(TorontoCore *system, size_t min_load_count) {
     parameters.min_load_ct = min_load_count;
     parameters.populate_data = data;
     parameters.populate_fn = Player_populate;
+    INSTRUMENT_PARAMETERS(parameters, "toronto");
     
     Village *object = (Village *) malloc(sizeof(Village));
     *object = toronto_new_village(system, &parameters);
@@ -413,6 +419,7 @@ void Players_toronto_free(TorontoCore *system, Village *object) {
     // Retrieve the parameters to finalize all the user objects within.
     VillageParameters parameters;
     village_params(object, &parameters);    
+    UNINSTRUMENT_PARAMETERS(parameters);
     Data *data = (Data *) parameters.populate_data;
 
     // Kill the DB connection
@@ -1,12 +1,64 @@
+#include <stdint.h>
+#include <stdbool.h>
 #include <stdlib.h>
 
+#include "random.h"
+
+// xoshiro256** (Blackman & Vigna, "Scrambled linear pseudorandom number
+// generators", 2018).
+typedef struct {
+    uint64_t state[4];
+    bool seeded;
+} Xoshiro256;
+
+static __thread Xoshiro256 generator;
+
+static inline uint64_t rotate_left(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// splitmix64, used to spread a single seed over the whole xoshiro state.
+static inline uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9e3779b97f4a7c15UL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9UL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebUL;
+    return z ^ (z >> 31);
+}
+
+void random_seed(uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+        generator.state[i] = splitmix64(&seed);
+    }
+    generator.seeded = true;
+}
+
+static inline uint64_t random_next() {
+    if (__builtin_expect(!generator.seeded, 0)) {
+        random_seed(0);
+    }
+    uint64_t *s = generator.state;
+    uint64_t result = rotate_left(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotate_left(s[3], 45);
+    return result;
+}
+
+// Maps a 64-bit draw onto [0, ceiling) with a multiply instead of a modulo
+// (Lemire, "Fast random integer generation in an interval", 2019).
 int random_int(int ceiling) {
-    return rand() % ceiling;
+    return (int) (((__uint128_t) random_next() * (uint64_t) ceiling) >> 64);
 }
 
 size_t random_index(size_t ceiling) {
-    size_t high = (size_t) rand();
-    size_t low  = (size_t) rand();
-    size_t big = (high << 32) | low;
-    return big % ceiling;
-}
\ No newline at end of file
+    return (size_t) (((__uint128_t) random_next() * (uint64_t) ceiling) >> 64);
+}
+
+double random_uniform() {
+    // 53 random bits, which is all a double can represent in [0, 1).
+    return (double) (random_next() >> 11) / (double) (1UL << 53);
+}
@@ -1,5 +1,12 @@
 #pragma once
 #include <stdint.h>
+#include <stddef.h>
+
+// Every thread has its own xoshiro256** generator, so drawing numbers takes
+// no locks and threads do not perturb each other's streams. A thread that
+// never calls random_seed draws from a stream seeded with 0.
+void random_seed(uint64_t seed);
 
 int random_int(int ceiling);
-size_t random_index(size_t ceiling);
\ No newline at end of file
+size_t random_index(size_t ceiling);
+double random_uniform();
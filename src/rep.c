@@ -0,0 +1,260 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "logging.h"
+#include "instrument.h"
+#include "rep.h"
+
+RepSource rep_source_vector(int64_t *vector, size_t length) {
+    RepSource source;
+    memset(&source, 0, sizeof(RepSource));
+    source.vector = vector;
+    source.length = length;
+    return source;
+}
+
+RepSource rep_source_Seq(Seq seq) {
+    RepSource source;
+    memset(&source, 0, sizeof(RepSource));
+    source.seq = seq;
+    source.length = seq.length;
+    return source;
+}
+
+Rep rep_times(RepSource x, size_t times) {
+    Rep data;
+    memset(&data, 0, sizeof(Rep));
+    data.x = x;
+    data.each = 1;
+    data.length = x.length * times;
+    return data;
+}
+
+Rep rep_each(RepSource x, size_t each) {
+    Rep data;
+    memset(&data, 0, sizeof(Rep));
+    data.x = x;
+    data.each = each;
+    data.length = x.length * each;
+    return data;
+}
+
+Rep rep_len(RepSource x, size_t length) {
+    Rep data;
+    memset(&data, 0, sizeof(Rep));
+    data.x = x;
+    data.each = 1;
+    data.length = length;
+    return data;
+}
+
+Rep rep_outer(RepSource x, RepSource y) {
+    Rep data;
+    memset(&data, 0, sizeof(Rep));
+    data.x = x;
+    data.y = y;
+    data.length = x.length * y.length;
+    data.outer = true;
+    return data;
+}
+
+static inline int64_t rep_source_element(RepSource *source, size_t index) {
+    return source->vector != NULL ? source->vector[index] : seq_element(source->seq, index);
+}
+
+// Writes source elements [from, from + count) scaled by factor: copied or
+// generated a whole run at a time rather than one element at a time.
+static void rep_source_run(RepSource *source, size_t from, size_t count, int64_t factor, int64_t *target) {
+    if (source->vector == NULL) {
+        Seq seq = factor == 1 ? source->seq : seq_scale(source->seq, factor);
+        seq_populate(&seq, from, from + count, (unsigned char *) target);
+    } else if (factor == 1) {
+        memcpy(target, source->vector + from, sizeof(int64_t) * count);
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            target[i] = source->vector[from + i] * factor;
+        }
+    }
+}
+
+// Walks the output in runs: stretches of consecutive base elements for
+// rep with each = 1 and for outer products, and stretches of one repeated
+// base element otherwise.
+int32_t rep_populate(void* user_data, uintptr_t start, uintptr_t end, unsigned char* target_bytes) {
+    Rep *data = (Rep *) user_data;
+    int64_t *target = (int64_t *) target_bytes;
+    size_t count = end - start;
+    size_t n = data->x.length;
+
+    if (data->outer) {
+        size_t i = start % n;
+        size_t j = start / n;
+        for (size_t k = 0; k < count; j++, i = 0) {
+            size_t run = n - i < count - k ? n - i : count - k;
+            rep_source_run(&data->x, i, run, rep_source_element(&data->y, j), target + k);
+            k += run;
+        }
+        return 0;
+    }
+
+    if (data->each == 1) {
+        for (size_t k = 0, i = start % n; k < count; i = 0) {
+            size_t run = n - i < count - k ? n - i : count - k;
+            rep_source_run(&data->x, i, run, 1, target + k);
+            k += run;
+        }
+        return 0;
+    }
+
+    size_t i = (start / data->each) % n;
+    size_t left = data->each - start % data->each;
+    for (size_t k = 0; k < count; ) {
+        int64_t value = rep_source_element(&data->x, i);
+        size_t run = left < count - k ? left : count - k;
+        for (size_t r = 0; r < run; r++) {
+            target[k + r] = value;
+        }
+        k += run;
+        left = data->each;
+        i = i + 1 == n ? 0 : i + 1;
+    }
+    return 0;
+}
+
+static bool rep_check(Rep *data) {
+    if (data->x.length == 0 || (data->outer && data->y.length == 0) || (!data->outer && data->each == 0)) {
+        REPORT("Cannot repeat an empty vector\n");
+        return false;
+    }
+    return true;
+}
+
+int64_t *rep_ufo_new(UfoCore *ufo_system, Rep rep, bool read_only, size_t min_load_count) {
+    if (!rep_check(&rep)) {
+        return NULL;
+    }
+    Rep *data = (Rep *) malloc(sizeof(Rep));
+    *data = rep;
+
+    UfoParameters parameters;
+    parameters.header_size = 0;
+    parameters.element_size = strideOf(int64_t);
+    parameters.element_ct = data->length;
+    parameters.min_load_ct = min_load_count;
+    parameters.read_only = read_only;
+    parameters.populate_data = data;
+    parameters.populate_fn = rep_populate;
+    INSTRUMENT_PARAMETERS(parameters, "ufo");
+
+    UfoObj ufo_object = ufo_new_object(ufo_system, &parameters);
+    if (ufo_is_error(&ufo_object)) {
+        fprintf(stderr, "Cannot create UFO object.\n");
+        return NULL;
+    }
+
+    int64_t *pointer = ufo_header_ptr(&ufo_object);
+    return pointer;
+}
+
+void rep_ufo_free(UfoCore *ufo_system, int64_t *ptr) {
+    UfoObj ufo_object = ufo_get_by_address(ufo_system, ptr);
+    if (ufo_is_error(&ufo_object)) {
+        fprintf(stderr, "Cannot free %p: not a UFO object.\n", ptr);
+        return;
+    }
+
+    UfoParameters parameters;
+    int result = ufo_get_params(ufo_system, &ufo_object, &parameters);
+    if (result < 0) {
+        REPORT("Unable to access UFO parameters, so cannot free repetition data\n");
+    }
+    UNINSTRUMENT_PARAMETERS(parameters);
+    free(parameters.populate_data);
+
+    ufo_free(ufo_object);
+}
+
+int64_t *rep_normil_new(Rep data) {
+    if (!rep_check(&data)) {
+        return NULL;
+    }
+    int64_t *target = (int64_t *) malloc(sizeof(int64_t) * data.length);
+    rep_populate(&data, 0, data.length, (unsigned char *) target);
+    return target;
+}
+
+void rep_normil_free(int64_t *ptr) {
+    free(ptr);
+}
+
+Borough *rep_nyc_new(NycCore *system, Rep rep, size_t min_load_count) {
+    if (!rep_check(&rep)) {
+        return NULL;
+    }
+    Rep *data = (Rep *) malloc(sizeof(Rep));
+    *data = rep;
+
+    BoroughParameters parameters;
+    parameters.header_size = 0;
+    parameters.element_size = strideOf(int64_t);
+    parameters.element_ct = data->length;
+    parameters.min_load_ct = min_load_count;
+    parameters.populate_data = data;
+    parameters.populate_fn = rep_populate;
+    INSTRUMENT_PARAMETERS(parameters, "nyc");
+
+    Borough *object = (Borough *) malloc(sizeof(Borough));
+    *object = nyc_new_borough(system, &parameters);
+    if (borough_is_error(object)) {
+        fprintf(stderr, "Cannot create NYC object.\n");
+        return NULL;
+    }
+
+    return object;
+}
+
+void rep_nyc_free(NycCore *system, Borough *object) {
+    BoroughParameters parameters;
+    borough_params(object, &parameters);
+    UNINSTRUMENT_PARAMETERS(parameters);
+    free(parameters.populate_data);
+    borough_free(*object);
+    free(object);
+}
+
+Village *rep_toronto_new(TorontoCore *system, Rep rep, size_t min_load_count) {
+    if (!rep_check(&rep)) {
+        return NULL;
+    }
+    Rep *data = (Rep *) malloc(sizeof(Rep));
+    *data = rep;
+
+    VillageParameters parameters;
+    parameters.header_size = 0;
+    parameters.element_size = strideOf(int64_t);
+    parameters.element_ct = data->length;
+    parameters.min_load_ct = min_load_count;
+    parameters.populate_data = data;
+    parameters.populate_fn = rep_populate;
+    INSTRUMENT_PARAMETERS(parameters, "toronto");
+
+    Village *object = (Village *) malloc(sizeof(Village));
+    *object = toronto_new_village(system, &parameters);
+    if (village_is_error(object)) {
+        fprintf(stderr, "Cannot create Toronto object.\n");
+        return NULL;
+    }
+
+    return object;
+}
+
+void rep_toronto_free(TorontoCore *system, Village *object) {
+    VillageParameters parameters;
+    village_params(object, &parameters);
+    UNINSTRUMENT_PARAMETERS(parameters);
+    free(parameters.populate_data);
+    village_free(*object);
+    free(object);
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ufo_c/target/ufo_c.h"
+#include "new_york/target/nyc.h"
+#include "toronto/target/toronto.h"
+
+#include "seq.h"
+
+// R-style repetitions and outer products of int64 vectors, generated chunk
+// by chunk from a small descriptor.
+
+// The vector being repeated: either an array, which has to outlive every
+// object made from it, or a sequence, which is never materialized. A base
+// that is a read-only seq UFO can be used through its descriptor, see
+// seq_ufo_descriptor, so that it is never faulted in.
+typedef struct {
+    int64_t *vector;   // NULL for a sequence.
+    Seq seq;
+    size_t length;
+} RepSource;
+
+// Element k of a repetition is x[(k / each) % x.length]. Element k of an
+// outer product is x[k % x.length] * y[k / x.length], the column-major
+// layout of R's outer(x, y).
+typedef struct {
+    RepSource x;
+    RepSource y;     // Only for outer products.
+    size_t each;     // Only for repetitions.
+    size_t length;
+    bool outer;
+} Rep;
+
+RepSource rep_source_vector(int64_t *vector, size_t length);
+RepSource rep_source_Seq(Seq seq);
+
+// rep(x, times), rep(x, each), rep_len(x, length), and outer(x, y).
+Rep rep_times(RepSource x, size_t times);
+Rep rep_each(RepSource x, size_t each);
+Rep rep_len(RepSource x, size_t length);
+Rep rep_outer(RepSource x, RepSource y);
+
+int32_t rep_populate(void* user_data, uintptr_t start, uintptr_t end, unsigned char* target_bytes);
+
+int64_t *rep_ufo_new(UfoCore *ufo_system, Rep data, bool read_only, size_t min_load_count);
+void rep_ufo_free(UfoCore *ufo_system, int64_t *ptr);
+
+int64_t *rep_normil_new(Rep data);
+void rep_normil_free(int64_t *ptr);
+
+Borough *rep_nyc_new(NycCore *system, Rep data, size_t min_load_count);
+void rep_nyc_free(NycCore *system, Borough *object);
+
+Village *rep_toronto_new(TorontoCore *system, Rep data, size_t min_load_count);
+void rep_toronto_free(TorontoCore *system, Village *object);
@@ -0,0 +1,142 @@
+#include "rep_benchmark.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "seq.h"
+#include "rep.h"
+
+#include "logging.h"
+
+typedef enum { REP_TIMES, REP_EACH, REP_LEN, REP_OUTER } RepKind;
+
+static const char *rep_benchmark_names[] = { "rep", "rep-each", "rep-len", "outer", NULL };
+
+bool rep_benchmark_known(char *benchmark) {
+    for (size_t i = 0; rep_benchmark_names[i] != NULL; i++) {
+        if (strcmp(rep_benchmark_names[i], benchmark) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static Seq rep_base_x(Arguments *config) {
+    Seq data;
+    data.from = 1;
+    data.by = 2;
+    data.length = config->base;
+    data.to = (data.length - 1) * data.by + data.from;
+    return data;
+}
+
+static Seq rep_base_y(Arguments *config) {
+    Seq data;
+    data.from = 1;
+    data.by = 1;
+    data.length = config->size / config->base;
+    data.to = data.length;
+    return data;
+}
+
+static Rep rep_of_kind(Arguments *config, RepKind kind, RepSource x, RepSource y) {
+    switch (kind) {
+        case REP_EACH:  return rep_each(x, config->size / config->base);
+        case REP_LEN:   return rep_len(x, config->size);
+        case REP_OUTER: return rep_outer(x, y);
+        default:        return rep_times(x, config->size / config->base);
+    }
+}
+
+// UFO
+// The bases are sequences, as for nyc and toronto, so they are never
+// materialized.
+static void *ufo_rep_new(Arguments *config, AnySystem system, RepKind kind) {
+    Rep data = rep_of_kind(config, kind, rep_source_Seq(rep_base_x(config)), rep_source_Seq(rep_base_y(config)));
+    return (void *) rep_ufo_new((UfoCore *) system, data, !config_has_writes(config), config->min_load);
+}
+void *ufo_rep_creation(Arguments *config, AnySystem system) {
+    return ufo_rep_new(config, system, REP_TIMES);
+}
+void *ufo_rep_each_creation(Arguments *config, AnySystem system) {
+    return ufo_rep_new(config, system, REP_EACH);
+}
+void *ufo_rep_len_creation(Arguments *config, AnySystem system) {
+    return ufo_rep_new(config, system, REP_LEN);
+}
+void *ufo_outer_creation(Arguments *config, AnySystem system) {
+    return ufo_rep_new(config, system, REP_OUTER);
+}
+void ufo_rep_cleanup(Arguments *config, AnySystem system, AnyObject object) {
+    rep_ufo_free((UfoCore *) system, object);
+}
+
+// NYC
+static void *ny_rep_new(Arguments *config, AnySystem system, RepKind kind) {
+    Rep data = rep_of_kind(config, kind, rep_source_Seq(rep_base_x(config)), rep_source_Seq(rep_base_y(config)));
+    return (void *) rep_nyc_new((NycCore *) system, data, config->min_load);
+}
+void *ny_rep_creation(Arguments *config, AnySystem system) {
+    return ny_rep_new(config, system, REP_TIMES);
+}
+void *ny_rep_each_creation(Arguments *config, AnySystem system) {
+    return ny_rep_new(config, system, REP_EACH);
+}
+void *ny_rep_len_creation(Arguments *config, AnySystem system) {
+    return ny_rep_new(config, system, REP_LEN);
+}
+void *ny_outer_creation(Arguments *config, AnySystem system) {
+    return ny_rep_new(config, system, REP_OUTER);
+}
+void ny_rep_cleanup(Arguments *config, AnySystem system, AnyObject object) {
+    rep_nyc_free((NycCore *) system, (Borough *) object);
+}
+
+// Toronto
+static void *toronto_rep_new(Arguments *config, AnySystem system, RepKind kind) {
+    Rep data = rep_of_kind(config, kind, rep_source_Seq(rep_base_x(config)), rep_source_Seq(rep_base_y(config)));
+    return (void *) rep_toronto_new((TorontoCore *) system, data, config->min_load);
+}
+void *toronto_rep_creation(Arguments *config, AnySystem system) {
+    return toronto_rep_new(config, system, REP_TIMES);
+}
+void *toronto_rep_each_creation(Arguments *config, AnySystem system) {
+    return toronto_rep_new(config, system, REP_EACH);
+}
+void *toronto_rep_len_creation(Arguments *config, AnySystem system) {
+    return toronto_rep_new(config, system, REP_LEN);
+}
+void *toronto_outer_creation(Arguments *config, AnySystem system) {
+    return toronto_rep_new(config, system, REP_OUTER);
+}
+void toronto_rep_cleanup(Arguments *config, AnySystem system, AnyObject object) {
+    rep_toronto_free((TorontoCore *) system, (Village *) object);
+}
+
+// Normil
+// Materializes the bases, and then the whole result, the way R would.
+static void *normil_rep_new(Arguments *config, AnySystem system, RepKind kind) {
+    Seq x = rep_base_x(config), y = rep_base_y(config);
+    int64_t *x_vector = seq_normil_from_Seq(x);
+    int64_t *y_vector = kind == REP_OUTER ? seq_normil_from_Seq(y) : NULL;
+    Rep data = rep_of_kind(config, kind, rep_source_vector(x_vector, x.length), rep_source_vector(y_vector, y.length));
+    int64_t *result = rep_normil_new(data);
+    seq_normil_free(x_vector);
+    if (y_vector != NULL) seq_normil_free(y_vector);
+    return (void *) result;
+}
+void *normil_rep_creation(Arguments *config, AnySystem system) {
+    return normil_rep_new(config, system, REP_TIMES);
+}
+void *normil_rep_each_creation(Arguments *config, AnySystem system) {
+    return normil_rep_new(config, system, REP_EACH);
+}
+void *normil_rep_len_creation(Arguments *config, AnySystem system) {
+    return normil_rep_new(config, system, REP_LEN);
+}
+void *normil_outer_creation(Arguments *config, AnySystem system) {
+    return normil_rep_new(config, system, REP_OUTER);
+}
+void normil_rep_cleanup(Arguments *config, AnySystem system, AnyObject object) {
+    rep_normil_free(object);
+}
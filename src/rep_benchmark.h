@@ -0,0 +1,34 @@
+#pragma once
+
+#include "bench.h"
+
+// The rep, rep-each, rep-len and outer benchmarks: rep(x, times),
+// rep(x, each), rep_len(x, size) and outer(x, y), where x = 1, 3, 5, ... has
+// --base elements and y = 1, 2, 3, ... has size / base. Every object has
+// --size elements.
+
+bool rep_benchmark_known(char *benchmark);
+
+void *ufo_rep_creation           (Arguments *config, AnySystem system);
+void *ufo_rep_each_creation      (Arguments *config, AnySystem system);
+void *ufo_rep_len_creation       (Arguments *config, AnySystem system);
+void *ufo_outer_creation         (Arguments *config, AnySystem system);
+void  ufo_rep_cleanup            (Arguments *config, AnySystem system, AnyObject object);
+
+void *ny_rep_creation            (Arguments *config, AnySystem system);
+void *ny_rep_each_creation       (Arguments *config, AnySystem system);
+void *ny_rep_len_creation        (Arguments *config, AnySystem system);
+void *ny_outer_creation          (Arguments *config, AnySystem system);
+void  ny_rep_cleanup             (Arguments *config, AnySystem system, AnyObject object);
+
+void *toronto_rep_creation       (Arguments *config, AnySystem system);
+void *toronto_rep_each_creation  (Arguments *config, AnySystem system);
+void *toronto_rep_len_creation   (Arguments *config, AnySystem system);
+void *toronto_outer_creation     (Arguments *config, AnySystem system);
+void  toronto_rep_cleanup        (Arguments *config, AnySystem system, AnyObject object);
+
+void *normil_rep_creation        (Arguments *config, AnySystem system);
+void *normil_rep_each_creation   (Arguments *config, AnySystem system);
+void *normil_rep_len_creation    (Arguments *config, AnySystem system);
+void *normil_outer_creation      (Arguments *config, AnySystem system);
+void  normil_rep_cleanup         (Arguments *config, AnySystem system, AnyObject object);
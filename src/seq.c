@@ -1,18 +1,108 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
 #include "logging.h"
+#include "instrument.h"
 #include "seq.h"
 
+// Chunks at least this large are filled with non-temporal stores, which go
+// around the cache, so that populating a large chunk does not evict the
+// working set of whoever faulted on it.
+#define SEQ_STREAMING_THRESHOLD (1024UL * 1024UL)
+
+// Fills target with count elements, first, first + by, ... Arithmetic is
+// unsigned, so it wraps around the same way for every kernel.
+typedef void (*seq_fill_t)(int64_t *target, size_t count, uint64_t first, uint64_t by);
+
+static void seq_fill_scalar(int64_t *target, size_t count, uint64_t first, uint64_t by) {
+    uint64_t value = first;
+    for (size_t i = 0; i < count; i++) {
+        target[i] = (int64_t) value;
+        value += by;
+    }
+}
+
+#if defined(__x86_64__)
+// The vector kernels step every lane by lanes * by instead of multiplying
+// for each element. Stores are aligned: a scalar head runs up to the first
+// vector boundary, and a scalar tail finishes off what is left.
+__attribute__((target("avx2")))
+static void seq_fill_avx2(int64_t *target, size_t count, uint64_t first, uint64_t by) {
+    size_t i = 0;
+    for (; i < count && ((uintptr_t) (target + i) & 31) != 0; i++) {
+        target[i] = (int64_t) (first + by * i);
+    }
+    size_t vectors_end = i + ((count - i) & ~(size_t) 3);
+    uint64_t value = first + by * i;
+    __m256i lanes = _mm256_set_epi64x(value + 3 * by, value + 2 * by, value + by, value);
+    __m256i step = _mm256_set1_epi64x((int64_t) (4 * by));
+    if ((vectors_end - i) * sizeof(int64_t) >= SEQ_STREAMING_THRESHOLD) {
+        for (; i < vectors_end; i += 4) {
+            _mm256_stream_si256((__m256i *) (target + i), lanes);
+            lanes = _mm256_add_epi64(lanes, step);
+        }
+        _mm_sfence();
+    } else {
+        for (; i < vectors_end; i += 4) {
+            _mm256_store_si256((__m256i *) (target + i), lanes);
+            lanes = _mm256_add_epi64(lanes, step);
+        }
+    }
+    seq_fill_scalar(target + i, count - i, first + by * i, by);
+}
+
+__attribute__((target("avx512f")))
+static void seq_fill_avx512(int64_t *target, size_t count, uint64_t first, uint64_t by) {
+    size_t i = 0;
+    for (; i < count && ((uintptr_t) (target + i) & 63) != 0; i++) {
+        target[i] = (int64_t) (first + by * i);
+    }
+    size_t vectors_end = i + ((count - i) & ~(size_t) 7);
+    uint64_t value = first + by * i;
+    __m512i lanes = _mm512_set_epi64(value + 7 * by, value + 6 * by, value + 5 * by, value + 4 * by,
+                                     value + 3 * by, value + 2 * by, value + by, value);
+    __m512i step = _mm512_set1_epi64((int64_t) (8 * by));
+    if ((vectors_end - i) * sizeof(int64_t) >= SEQ_STREAMING_THRESHOLD) {
+        for (; i < vectors_end; i += 8) {
+            _mm512_stream_si512((__m512i *) (target + i), lanes);
+            lanes = _mm512_add_epi64(lanes, step);
+        }
+        _mm_sfence();
+    } else {
+        for (; i < vectors_end; i += 8) {
+            _mm512_store_si512((__m512i *) (target + i), lanes);
+            lanes = _mm512_add_epi64(lanes, step);
+        }
+    }
+    seq_fill_scalar(target + i, count - i, first + by * i, by);
+}
+#endif
+
+static seq_fill_t seq_fill = seq_fill_scalar;
+
+// Picks the widest kernel the CPU supports, once, before main.
+__attribute__((constructor))
+static void seq_fill_select() {
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        seq_fill = seq_fill_avx512;
+    } else if (__builtin_cpu_supports("avx2")) {
+        seq_fill = seq_fill_avx2;
+    }
+#endif
+}
+
 int32_t seq_populate(void* user_data, uintptr_t start, uintptr_t end, unsigned char* target_bytes) {
 
     Seq *data = (Seq *) user_data;
     int64_t* target = (int64_t *)  target_bytes;
 
-    for (size_t i = 0; i < end - start; i++) {
-        target[i] = data->from + data->by * (i + start);
-    }
+    seq_fill(target, end - start, data->from + data->by * start, data->by);
 
     return 0;
 }
@@ -45,9 +135,10 @@ int64_t *seq_ufo_from_Seq(UfoCore *ufo_system, Seq seq, bool read_only, size_t m
     parameters.element_size = strideOf(int64_t);
     parameters.element_ct = data->length;
     parameters.min_load_ct = min_load_count;
-    parameters.read_only = false;
+    parameters.read_only = read_only;
     parameters.populate_data = data; // populate data is copied by UFO, so this should be fine.
     parameters.populate_fn = seq_populate;
+    INSTRUMENT_PARAMETERS(parameters, "ufo");
 
     UfoObj ufo_object = ufo_new_object(ufo_system, &parameters);
     if (ufo_is_error(&ufo_object)) {
@@ -71,11 +162,166 @@ void seq_ufo_free(UfoCore *ufo_system, int64_t *ptr) {
     if (result < 0) {
         REPORT("Unable to access UFO parameters, so cannot free source matrix\n");
     }
+    UNINSTRUMENT_PARAMETERS(parameters);
     free(parameters.populate_data);
 
     ufo_free(ufo_object);
 }
 
+// SYMBOLIC ARITHMETIC
+static Seq seq_of(size_t from, size_t by, size_t length) {
+    Seq data;
+    data.from = from;
+    data.by = by;
+    data.length = length;
+    data.to = from + by * (length - 1);
+    return data;
+}
+
+int64_t seq_element(Seq data, size_t index) {
+    return (int64_t) (data.from + data.by * index);
+}
+
+Seq seq_add(Seq data, int64_t constant) {
+    return seq_of(data.from + (size_t) constant, data.by, data.length);
+}
+
+Seq seq_scale(Seq data, int64_t factor) {
+    return seq_of(data.from * (size_t) factor, data.by * (size_t) factor, data.length);
+}
+
+bool seq_add_Seq(Seq a, Seq b, Seq *result) {
+    if (a.length != b.length) {
+        return false;
+    }
+    *result = seq_of(a.from + b.from, a.by + b.by, a.length);
+    return true;
+}
+
+// n * from + by * n * (n - 1) / 2, halving whichever of n and n - 1 is even
+// first, so that the product only wraps where the sum itself would.
+int64_t seq_sum(Seq data) {
+    size_t n = data.length;
+    if (n == 0) {
+        return 0;
+    }
+    size_t pairs = n % 2 == 0 ? (n / 2) * (n - 1) : n * ((n - 1) / 2);
+    return (int64_t) (n * data.from + data.by * pairs);
+}
+
+// The last element, if no element on the way overflows int64.
+static bool seq_last(Seq data, int64_t *last) {
+    if (data.length == 0 || data.length - 1 > INT64_MAX) {
+        return false;
+    }
+    int64_t span;
+    return !__builtin_mul_overflow((int64_t) data.by, (int64_t) (data.length - 1), &span)
+        && !__builtin_add_overflow((int64_t) data.from, span, last);
+}
+
+bool seq_min(Seq data, int64_t *min) {
+    int64_t last;
+    if (!seq_last(data, &last)) {
+        return false;
+    }
+    *min = (int64_t) data.by >= 0 ? (int64_t) data.from : last;
+    return true;
+}
+
+bool seq_max(Seq data, int64_t *max) {
+    int64_t last;
+    if (!seq_last(data, &last)) {
+        return false;
+    }
+    *max = (int64_t) data.by >= 0 ? last : (int64_t) data.from;
+    return true;
+}
+
+// Checks the range first and then divides in unsigned arithmetic: between
+// from and the last element the distance always fits in uint64, whereas the
+// signed distance % by traps for INT64_MIN % -1, as in looking up INT64_MIN
+// in 0, -1, -2, ...
+bool seq_index_of(Seq data, int64_t value, size_t *index) {
+    int64_t last;
+    if (!seq_last(data, &last)) {
+        return false;
+    }
+    int64_t from = (int64_t) data.from;
+    int64_t by = (int64_t) data.by;
+    if (by == 0) {
+        *index = 0;
+        return value == from;
+    }
+    if (by > 0 ? (value < from || value > last) : (value > from || value < last)) {
+        return false;
+    }
+    uint64_t distance = by > 0 ? (uint64_t) value - (uint64_t) from : (uint64_t) from - (uint64_t) value;
+    uint64_t step = by > 0 ? (uint64_t) by : -(uint64_t) by;
+    if (distance % step != 0) {
+        return false;
+    }
+    *index = (size_t) (distance / step);
+    return true;
+}
+
+bool seq_ufo_descriptor(UfoCore *ufo_system, int64_t *ptr, Seq *data, size_t *min_load_count) {
+    UfoObj ufo_object = ufo_get_by_address(ufo_system, ptr);
+    if (ufo_is_error(&ufo_object)) {
+        REPORT("%p is not a UFO object\n", ptr);
+        return false;
+    }
+    UfoParameters parameters;
+    if (ufo_get_params(ufo_system, &ufo_object, &parameters) < 0) {
+        REPORT("Unable to access UFO parameters of %p\n", ptr);
+        return false;
+    }
+    if (INSTRUMENTED_FUNCTION(parameters) != seq_populate) {
+        REPORT("%p is not a seq UFO object\n", ptr);
+        return false;
+    }
+    if (!parameters.read_only) {
+        REPORT("%p is writable, so it may no longer hold its sequence\n", ptr);
+        return false;
+    }
+    *data = *((Seq *) INSTRUMENTED_DATA(parameters));
+    if (min_load_count != NULL) {
+        *min_load_count = parameters.min_load_ct;
+    }
+    return true;
+}
+
+int64_t *seq_ufo_add(UfoCore *ufo_system, int64_t *ptr, int64_t constant) {
+    Seq data;
+    size_t min_load_count;
+    if (!seq_ufo_descriptor(ufo_system, ptr, &data, &min_load_count)) {
+        return NULL;
+    }
+    return seq_ufo_from_Seq(ufo_system, seq_add(data, constant), true, min_load_count);
+}
+
+int64_t *seq_ufo_scale(UfoCore *ufo_system, int64_t *ptr, int64_t factor) {
+    Seq data;
+    size_t min_load_count;
+    if (!seq_ufo_descriptor(ufo_system, ptr, &data, &min_load_count)) {
+        return NULL;
+    }
+    return seq_ufo_from_Seq(ufo_system, seq_scale(data, factor), true, min_load_count);
+}
+
+int64_t *seq_ufo_add_ufo(UfoCore *ufo_system, int64_t *a, int64_t *b) {
+    Seq a_data, b_data, result;
+    size_t min_load_count;
+    if (!seq_ufo_descriptor(ufo_system, a, &a_data, &min_load_count)
+        || !seq_ufo_descriptor(ufo_system, b, &b_data, NULL)) {
+        return NULL;
+    }
+    if (!seq_add_Seq(a_data, b_data, &result)) {
+        REPORT("Cannot add sequences of %lu and %lu elements\n", a_data.length, b_data.length);
+        return NULL;
+    }
+    return seq_ufo_from_Seq(ufo_system, result, true, min_load_count);
+}
+
 int64_t *seq_normil_new(size_t from, size_t to, size_t by) {
     Seq data;
     data.from = from; 
@@ -128,6 +374,7 @@ Borough *seq_nyc_from_Seq(NycCore *system, Seq seq, size_t min_load_count) {
     parameters.min_load_ct = min_load_count;
     parameters.populate_data = data; // populate data is copied by UFO, so this should be fine.
     parameters.populate_fn = seq_populate;
+    INSTRUMENT_PARAMETERS(parameters, "nyc");
 
     Borough *object = (Borough *) malloc(sizeof(Borough));
     *object = nyc_new_borough(system, &parameters);
@@ -141,6 +388,7 @@ Borough *seq_nyc_from_Seq(NycCore *system, Seq seq, size_t min_load_count) {
 void seq_nyc_free(NycCore *system, Borough *object) {    
     BoroughParameters parameters;
     borough_params(object, &parameters);
+    UNINSTRUMENT_PARAMETERS(parameters);
     free(parameters.populate_data);
     borough_free(*object);
     free(object);
@@ -174,6 +422,7 @@ Village *seq_toronto_from_Seq(TorontoCore *system, Seq seq, size_t min_load_coun
     parameters.min_load_ct = min_load_count;
     parameters.populate_data = data; // populate data is copied by UFO, so this should be fine.
     parameters.populate_fn = seq_populate;
+    INSTRUMENT_PARAMETERS(parameters, "toronto");
 
     Village *object = (Village *) malloc(sizeof(Village));
     *object = toronto_new_village(system, &parameters);
@@ -187,6 +436,7 @@ Village *seq_toronto_from_Seq(TorontoCore *system, Seq seq, size_t min_load_coun
 void seq_toronto_free(TorontoCore *system, Village *object) {  
     VillageParameters parameters;
     village_params(object, &parameters);
+    UNINSTRUMENT_PARAMETERS(parameters);
     free(parameters.populate_data);  
     village_free(*object);
     free(object);
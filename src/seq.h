@@ -22,6 +22,32 @@ int64_t *seq_ufo_new(UfoCore *ufo_system, size_t from, size_t to, size_t by, boo
 int64_t *seq_ufo_from_Seq(UfoCore *ufo_system, Seq data, bool read_only, size_t min_load_count);
 void seq_ufo_free(UfoCore *ufo_system, int64_t *ptr);
 
+// Symbolic arithmetic: a constant added to a sequence, a sequence scaled by
+// a factor, and the sum of two sequences of equal length are sequences too.
+// Elements wrap around like int64 arithmetic, so negative constants, factors
+// and steps work.
+int64_t seq_element(Seq data, size_t index);
+Seq seq_add(Seq data, int64_t constant);
+Seq seq_scale(Seq data, int64_t factor);
+bool seq_add_Seq(Seq a, Seq b, Seq *result);
+
+// Closed-form queries. The sum wraps around like summing the elements does.
+// The others are false for empty sequences and sequences that overflow int64.
+// index_of finds the first index of the value.
+int64_t seq_sum(Seq data);
+bool seq_min(Seq data, int64_t *min);
+bool seq_max(Seq data, int64_t *max);
+bool seq_index_of(Seq data, int64_t value, size_t *index);
+
+// The same on seq UFOs, without populating anything. Only read-only objects
+// are guaranteed to still hold the sequence their descriptor describes, so
+// these fail on writable ones. The results are read-only UFOs with the
+// min_load_count of the (first) operand.
+bool seq_ufo_descriptor(UfoCore *ufo_system, int64_t *ptr, Seq *data, size_t *min_load_count);
+int64_t *seq_ufo_add(UfoCore *ufo_system, int64_t *ptr, int64_t constant);
+int64_t *seq_ufo_scale(UfoCore *ufo_system, int64_t *ptr, int64_t factor);
+int64_t *seq_ufo_add_ufo(UfoCore *ufo_system, int64_t *a, int64_t *b);
+
 int64_t *seq_normil_new(size_t from, size_t to, size_t by);
 int64_t *seq_normil_from_length(size_t from, size_t length, size_t by);
 int64_t *seq_normil_from_Seq(Seq data);
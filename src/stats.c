@@ -0,0 +1,85 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stats.h"
+
+// Critical values for 1 to 30 degrees of freedom.
+static const double t_table[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+     2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+     2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+};
+
+double student_t_critical(double degrees_of_freedom) {
+    if (degrees_of_freedom < 1) {
+        return INFINITY;
+    }
+    if (degrees_of_freedom <= 30) {
+        return t_table[(size_t) degrees_of_freedom - 1];
+    }
+    if (degrees_of_freedom <= 40)  return 2.021;
+    if (degrees_of_freedom <= 60)  return 2.000;
+    if (degrees_of_freedom <= 120) return 1.980;
+    return 1.960;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *) a;
+    double y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+void Summary_compute(Summary *summary, const double *samples, size_t count) {
+    memset(summary, 0, sizeof(Summary));
+    summary->count = count;
+    if (count == 0) {
+        return;
+    }
+
+    double sum = 0;
+    for (size_t i = 0; i < count; i++) {
+        sum += samples[i];
+    }
+    summary->mean = sum / (double) count;
+
+    double squares = 0;
+    for (size_t i = 0; i < count; i++) {
+        squares += (samples[i] - summary->mean) * (samples[i] - summary->mean);
+    }
+    summary->stddev = count > 1 ? sqrt(squares / (double) (count - 1)) : 0;
+
+    double *sorted = (double *) malloc(sizeof(double) * count);
+    memcpy(sorted, samples, sizeof(double) * count);
+    qsort(sorted, count, sizeof(double), compare_doubles);
+    summary->median = (count % 2 == 1) 
+        ? sorted[count / 2] 
+        : (sorted[count / 2 - 1] + sorted[count / 2]) / 2.0;
+    free(sorted);
+
+    double margin = count > 1 
+        ? student_t_critical((double) (count - 1)) * summary->stddev / sqrt((double) count)
+        : 0;
+    summary->ci_low = summary->mean - margin;
+    summary->ci_high = summary->mean + margin;
+}
+
+bool welch_test(const Summary *a, const Summary *b, double *t, double *degrees_of_freedom) {
+    *t = 0;
+    *degrees_of_freedom = 0;
+    if (a->count < 2 || b->count < 2) {
+        return false;
+    }
+    double va = a->stddev * a->stddev / (double) a->count;
+    double vb = b->stddev * b->stddev / (double) b->count;
+    if (va + vb == 0) {
+        // No noise at all: any difference is a real one.
+        *t = b->mean == a->mean ? 0 : copysign(INFINITY, b->mean - a->mean);
+        *degrees_of_freedom = (double) (a->count + b->count - 2);
+        return b->mean != a->mean;
+    }
+    *t = (b->mean - a->mean) / sqrt(va + vb);
+    *degrees_of_freedom = (va + vb) * (va + vb) 
+        / (va * va / (double) (a->count - 1) + vb * vb / (double) (b->count - 1));
+    return fabs(*t) > student_t_critical(*degrees_of_freedom);
+}
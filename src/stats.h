@@ -0,0 +1,23 @@
+#pragma once
+#include <stddef.h>
+#include <stdbool.h>
+
+// Descriptive statistics over a set of measurements.
+typedef struct {
+    size_t count;
+    double mean;
+    double stddev;      // Sample standard deviation.
+    double median;
+    double ci_low;      // 95% confidence interval of the mean.
+    double ci_high;
+} Summary;
+
+void Summary_compute(Summary *summary, const double *samples, size_t count);
+
+// Two-sided 95% critical value of Student's t distribution.
+double student_t_critical(double degrees_of_freedom);
+
+// Welch's unequal-variance t-test of the difference between the means of b
+// and a. Returns whether the difference is significant at the 5% level.
+// Needs at least two samples on each side.
+bool welch_test(const Summary *a, const Summary *b, double *t, double *degrees_of_freedom);
@@ -12,7 +12,9 @@
 #include "toronto/target/toronto.h"
 
 #include "random.h"
+#include "timing.h"
 #include "logging.h"
+#include "instrument.h"
 
 void *toronto_setup(Arguments *config) {
     TorontoCore toronto_system = toronto_new_core("/tmp/", config->high_water_mark, config->low_water_mark);
@@ -39,30 +41,38 @@ size_t toronto_max_length(Arguments *config, AnySystem system, AnyObject object)
 // Fibonacci
 void *toronto_fib_creation(Arguments *config, AnySystem system) {
     TorontoCore *toronto_system_ptr = (TorontoCore *) system;
-    return (void *) toronto_fib_new(toronto_system_ptr, config->size, config->min_load);
+    return (void *) toronto_fib_new(toronto_system_ptr, config->size, config->fib_mode, config->min_load);
 }
 void toronto_fib_cleanup(Arguments *config, AnySystem system, AnyObject object) {
     TorontoCore *toronto_system_ptr = (TorontoCore *) system;
     toronto_fib_free(toronto_system_ptr, object);
 }
-void toronto_fib_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette) {
+void toronto_fib_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
     Village *village = (Village *) object;    
     uint64_t sum = 0;
-    SequenceResult result;
-    while (true) {
-        result = next(config, sequence);        
-        if (result.end) {
-            break;
+    SequenceBatch batch;
+    while (next(config, sequence, &batch) > 0) {
+        for (size_t i = 0; i < batch.length; i++) {
+            uint64_t start_time = Histogram_tick(latencies) ? current_time_in_ns() : 0;
+            if (batch.access[i] == ACCESS_READ) {
+                uint64_t value;
+                village_read(village, batch.current[i], &value);
+                sum += value;
+            } else if (batch.access[i] == ACCESS_WRITE) {
+                uint64_t value = (uint64_t) random_int(1000);
+                village_write(village, batch.current[i], &value);
+            } else {
+                uint64_t value;
+                village_read(village, batch.current[i], &value);
+                sum += value;
+                value += 1;
+                village_write(village, batch.current[i], &value);
+            }
+            if (start_time != 0) {
+                Histogram_record(latencies, current_time_in_ns() - start_time);
+            }
         }
-        if (result.write) {
-            uint64_t value = (uint64_t) random_int(1000);
-            village_write(village, result.current, &value);
-        } else {
-            uint64_t value;
-            village_read(village, result.current, &value);
-            sum += value;
-        }
-    };
+    }
     *oubliette = sum;
 }
 
@@ -75,24 +85,32 @@ void toronto_bzip_cleanup(Arguments *config, AnySystem system, AnyObject object)
     TorontoCore *toronto_system_ptr = (TorontoCore *) system;
     BZip2_toronto_free(toronto_system_ptr, object);
 }
-void toronto_bzip_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette) {
+void toronto_bzip_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
     Village *village = (Village *) object; 
     uint64_t sum = 0;
-    SequenceResult result;
-    while (true) {
-        result = next(config, sequence);        
-        if (result.end) {
-            break;
-        }        
-        if (result.write) {
-            char value = (char) random_int(126 - 32) + 32;
-            village_write(village, result.current, &value);
-        } else {
-            char value;
-            village_read(village, result.current, &value);
-            sum += value;
+    SequenceBatch batch;
+    while (next(config, sequence, &batch) > 0) {
+        for (size_t i = 0; i < batch.length; i++) {
+            uint64_t start_time = Histogram_tick(latencies) ? current_time_in_ns() : 0;
+            if (batch.access[i] == ACCESS_READ) {
+                char value;
+                village_read(village, batch.current[i], &value);
+                sum += value;
+            } else if (batch.access[i] == ACCESS_WRITE) {
+                char value = (char) random_int(126 - 32) + 32;
+                village_write(village, batch.current[i], &value);
+            } else {
+                char value;
+                village_read(village, batch.current[i], &value);
+                sum += value;
+                value += 1;
+                village_write(village, batch.current[i], &value);
+            }
+            if (start_time != 0) {
+                Histogram_record(latencies, current_time_in_ns() - start_time);
+            }
         }
-    };
+    }
     *oubliette = sum;
 }
 
@@ -105,24 +123,32 @@ void toronto_seq_cleanup(Arguments *config, AnySystem system, AnyObject object)
     TorontoCore *toronto_system_ptr = (TorontoCore *) system;
     seq_toronto_free(toronto_system_ptr, object);
 }
-void toronto_seq_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette) {
+void toronto_seq_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
     Village *village = (Village *) object;  
     int64_t sum = 0;
-    SequenceResult result;
-    while (true) {
-        result = next(config, sequence);        
-        if (result.end) {
-            break;
-        }        
-        if (result.write) {
-            int64_t value = random_int(1000);
-            village_write(village, result.current, &value);
-        } else {
-            int64_t value;
-            village_read(village, result.current, &value);
-            sum += value;
+    SequenceBatch batch;
+    while (next(config, sequence, &batch) > 0) {
+        for (size_t i = 0; i < batch.length; i++) {
+            uint64_t start_time = Histogram_tick(latencies) ? current_time_in_ns() : 0;
+            if (batch.access[i] == ACCESS_READ) {
+                int64_t value;
+                village_read(village, batch.current[i], &value);
+                sum += value;
+            } else if (batch.access[i] == ACCESS_WRITE) {
+                int64_t value = random_int(1000);
+                village_write(village, batch.current[i], &value);
+            } else {
+                int64_t value;
+                village_read(village, batch.current[i], &value);
+                sum += value;
+                value += 1;
+                village_write(village, batch.current[i], &value);
+            }
+            if (start_time != 0) {
+                Histogram_record(latencies, current_time_in_ns() - start_time);
+            }
         }
-    };
+    }
     *oubliette = sum;
 }
 
@@ -135,29 +161,39 @@ void toronto_psql_cleanup(Arguments *config, AnySystem system, AnyObject object)
     TorontoCore *toronto_system_ptr = (TorontoCore *) system;
     Players_toronto_free(toronto_system_ptr, object);
 }
-void toronto_psql_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette) {
+void toronto_psql_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
     Village *village = (Village *) object;  
     int64_t tds = 0;
     int64_t mvp = 0;
-    SequenceResult result;
-    while (true) {
-        result = next(config, sequence);        
-        if (result.end) {
-            break;
-        }        
-        if (result.write) {
-            Player value;
-            village_read(village, result.current, &value);
-            value.tds = random_int(100);
-            value.mvp = random_int(100);
-            village_write(village, result.current, &value);
-        } else {         
-            Player value;               
-            village_read(village, result.current, &value);
-            tds += value.tds;
-            mvp += value.mvp;
+    SequenceBatch batch;
+    while (next(config, sequence, &batch) > 0) {
+        for (size_t i = 0; i < batch.length; i++) {
+            uint64_t start_time = Histogram_tick(latencies) ? current_time_in_ns() : 0;
+            if (batch.access[i] == ACCESS_READ) {
+                Player value;
+                village_read(village, batch.current[i], &value);
+                tds += value.tds;
+                mvp += value.mvp;
+            } else if (batch.access[i] == ACCESS_WRITE) {
+                Player value;
+                village_read(village, batch.current[i], &value);
+                value.tds = random_int(100);
+                value.mvp = random_int(100);
+                village_write(village, batch.current[i], &value);
+            } else {
+                Player value;
+                village_read(village, batch.current[i], &value);
+                tds += value.tds;
+                mvp += value.mvp;
+                value.tds += 1;
+                value.mvp += 1;
+                village_write(village, batch.current[i], &value);
+            }
+            if (start_time != 0) {
+                Histogram_record(latencies, current_time_in_ns() - start_time);
+            }
         }
-    };
+    }
     *oubliette = tds + mvp;
 }
 
@@ -170,24 +206,32 @@ void toronto_mmap_cleanup(Arguments *config, AnySystem system, AnyObject object)
     TorontoCore *toronto_system_ptr = (TorontoCore *) system;
     MMap_toronto_free(toronto_system_ptr, object);
 }
-void toronto_mmap_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette) {
+void toronto_mmap_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
     Village *village = (Village *) object; 
     uint64_t sum = 0;
-    SequenceResult result;
-    while (true) {
-        result = next(config, sequence);        
-        if (result.end) {
-            break;
-        }        
-        if (result.write) {
-            char value = (char) random_int(126 - 32) + 32;
-            village_write(village, result.current, &value);
-        } else {
-            char value;
-            village_read(village, result.current, &value);
-            sum += value;
+    SequenceBatch batch;
+    while (next(config, sequence, &batch) > 0) {
+        for (size_t i = 0; i < batch.length; i++) {
+            uint64_t start_time = Histogram_tick(latencies) ? current_time_in_ns() : 0;
+            if (batch.access[i] == ACCESS_READ) {
+                char value;
+                village_read(village, batch.current[i], &value);
+                sum += value;
+            } else if (batch.access[i] == ACCESS_WRITE) {
+                char value = (char) random_int(126 - 32) + 32;
+                village_write(village, batch.current[i], &value);
+            } else {
+                char value;
+                village_read(village, batch.current[i], &value);
+                sum += value;
+                value += 1;
+                village_write(village, batch.current[i], &value);
+            }
+            if (start_time != 0) {
+                Histogram_record(latencies, current_time_in_ns() - start_time);
+            }
         }
-    };
+    }
     *oubliette = sum;
 }
 
@@ -203,28 +247,36 @@ void toronto_col_cleanup(Arguments *config, AnySystem system, AnyObject object)
 
     VillageParameters parameters;
     village_params(toronto_object, &parameters);
-    ColumnSpec *spec = (ColumnSpec *) parameters.populate_data;
+    ColumnSpec *spec = (ColumnSpec *) INSTRUMENTED_DATA(parameters);
     col_source_matrix_free(spec->source, spec->size);
 
     col_toronto_free(toronto_system, toronto_object);   
 }
-void toronto_col_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, volatile int64_t *oubliette) {
+void toronto_col_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
     Village *village = (Village *) object; 
     int64_t sum = 0;
-    SequenceResult result;
-    while (true) {
-        result = next(config, sequence);     
-        if (result.end) {
-            break;
-        }        
-        if (result.write) {
-            int32_t value = (int32_t) random_int(1000);
-            village_write(village, result.current, &value);
-        } else {
-            int32_t value;
-            village_read(village, result.current, &value);
-            sum += value;
+    SequenceBatch batch;
+    while (next(config, sequence, &batch) > 0) {
+        for (size_t i = 0; i < batch.length; i++) {
+            uint64_t start_time = Histogram_tick(latencies) ? current_time_in_ns() : 0;
+            if (batch.access[i] == ACCESS_READ) {
+                int32_t value;
+                village_read(village, batch.current[i], &value);
+                sum += value;
+            } else if (batch.access[i] == ACCESS_WRITE) {
+                int32_t value = (int32_t) random_int(1000);
+                village_write(village, batch.current[i], &value);
+            } else {
+                int32_t value;
+                village_read(village, batch.current[i], &value);
+                sum += value;
+                value += 1;
+                village_write(village, batch.current[i], &value);
+            }
+            if (start_time != 0) {
+                Histogram_record(latencies, current_time_in_ns() - start_time);
+            }
         }
-    };
+    }
     *oubliette = sum;
 }
@@ -0,0 +1,189 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+
+#include "logging.h"
+#include "trace.h"
+
+typedef enum { TRACE_POPULATE, TRACE_PHASE, TRACE_THREAD_NAME } TraceEventKind;
+
+typedef struct {
+    TraceEventKind kind;
+    pid_t tid;
+    const char *name;       // Backend for populate events, phase name for phases, or thread name.
+    const void *object;
+    uintptr_t start;        // Range, or repetition for phases.
+    uintptr_t end;
+    uint64_t start_time;
+    uint64_t end_time;
+} TraceEvent;
+
+// A buffer is handed to another thread once its thread exits, events and
+// all, which is why every event carries its thread.
+typedef struct {
+    pid_t tid;
+    size_t recorded;        // Total events ever recorded; the ring holds the last `capacity`.
+    TraceEvent *events;
+} TraceBuffer;
+
+static TraceBuffer buffers[TRACE_MAX_THREADS];
+static size_t buffers_count = 0;
+static size_t free_buffers[TRACE_MAX_THREADS];
+static size_t free_buffers_count = 0;
+static size_t overflowed = 0;    // Threads that found no buffer, and recorded nothing.
+static pthread_mutex_t buffers_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t buffer_key;
+static pthread_once_t buffer_key_once = PTHREAD_ONCE_INIT;
+static __thread TraceBuffer *current_buffer = NULL;
+static __thread bool current_overflowed = false;
+static size_t capacity = 0;
+static char *trace_path = NULL;
+static bool enabled = false;
+
+static void trace_flush_at_exit() {
+    trace_flush();
+}
+
+void trace_start(const char *path, size_t events_per_thread) {
+    trace_path = strdup(path);
+    capacity = events_per_thread == 0 ? 1 : events_per_thread;
+    enabled = true;
+    atexit(trace_flush_at_exit);
+}
+
+bool trace_enabled() {
+    return enabled;
+}
+
+static void trace_release(void *buffer) {
+    pthread_mutex_lock(&buffers_lock);
+    free_buffers[free_buffers_count++] = (TraceBuffer *) buffer - buffers;
+    pthread_mutex_unlock(&buffers_lock);
+}
+
+static void trace_create_key() {
+    pthread_key_create(&buffer_key, trace_release);
+}
+
+static TraceBuffer *trace_buffer() {
+    if (__builtin_expect(current_buffer == NULL && !current_overflowed, 0)) {
+        pthread_once(&buffer_key_once, trace_create_key);
+        pthread_mutex_lock(&buffers_lock);
+        TraceBuffer *buffer = NULL;
+        if (free_buffers_count > 0) {
+            buffer = &buffers[free_buffers[--free_buffers_count]];
+        } else if (buffers_count < TRACE_MAX_THREADS) {
+            buffer = &buffers[buffers_count];
+            buffer->recorded = 0;
+            buffer->events = (TraceEvent *) malloc(sizeof(TraceEvent) * capacity);
+            __atomic_store_n(&buffers_count, buffers_count + 1, __ATOMIC_RELEASE);
+        } else {
+            overflowed++;
+        }
+        pthread_mutex_unlock(&buffers_lock);
+
+        if (buffer == NULL) {
+            current_overflowed = true;
+            return NULL;
+        }
+        buffer->tid = (pid_t) syscall(SYS_gettid);
+        pthread_setspecific(buffer_key, buffer);
+        current_buffer = buffer;
+    }
+    return current_buffer;
+}
+
+static inline void trace_record(TraceEvent *event) {
+    if (!enabled) {
+        return;
+    }
+    TraceBuffer *buffer = trace_buffer();
+    if (buffer == NULL || buffer->events == NULL) {
+        return;
+    }
+    event->tid = buffer->tid;
+    buffer->events[buffer->recorded % capacity] = *event;
+    __atomic_store_n(&buffer->recorded, buffer->recorded + 1, __ATOMIC_RELEASE);
+}
+
+void trace_populate(const char *backend, const void *object, uintptr_t start, uintptr_t end,
+                    uint64_t start_time, uint64_t end_time) {
+    TraceEvent event = { TRACE_POPULATE, 0, backend, object, start, end, start_time, end_time };
+    trace_record(&event);
+}
+
+void trace_phase(const char *phase, size_t repetition, uint64_t start_time, uint64_t end_time) {
+    TraceEvent event = { TRACE_PHASE, 0, phase, NULL, repetition, 0, start_time, end_time };
+    trace_record(&event);
+}
+
+void trace_thread_name(const char *name) {
+    TraceEvent event = { TRACE_THREAD_NAME, 0, name, NULL, 0, 0, 0, 0 };
+    trace_record(&event);
+}
+
+// Chrome traces are in microseconds.
+static void trace_write_event(FILE *output_stream, pid_t pid, TraceEvent *event, bool first) {
+    pid_t tid = event->tid;
+    double ts = ((double) event->start_time) / 1000.0;
+    double dur = ((double) (event->end_time - event->start_time)) / 1000.0;
+    if (event->kind == TRACE_THREAD_NAME) {
+        fprintf(output_stream, 
+            "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+            first ? "" : ",", pid, tid, event->name);
+    } else if (event->kind == TRACE_POPULATE) {
+        fprintf(output_stream, 
+            "%s\n{\"name\":\"populate\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d,"
+            "\"args\":{\"object\":\"%p\",\"start\":%lu,\"end\":%lu}}",
+            first ? "" : ",", event->name, ts, dur, pid, tid, event->object, event->start, event->end);
+    } else {
+        fprintf(output_stream, 
+            "%s\n{\"name\":\"%s\",\"cat\":\"phase\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d,"
+            "\"args\":{\"repetition\":%lu}}",
+            first ? "" : ",", event->name, ts, dur, pid, tid, event->start);
+    }
+}
+
+void trace_flush() {
+    if (!enabled) {
+        return;
+    }
+    enabled = false;
+
+    FILE *output_stream = fopen(trace_path, "w");
+    if (output_stream == NULL) {
+        REPORT("Cannot open trace file \"%s\"\n", trace_path);
+        return;
+    }
+
+    pid_t pid = getpid();
+    size_t count = __atomic_load_n(&buffers_count, __ATOMIC_ACQUIRE);
+    if (overflowed > 0) {
+        WARN("%lu threads found all %d trace buffers taken and recorded nothing\n", overflowed, TRACE_MAX_THREADS);
+    }
+
+    size_t dropped = 0;
+    bool first = true;
+    fprintf(output_stream, "{\"traceEvents\":[");
+    for (size_t i = 0; i < count; i++) {
+        TraceBuffer *buffer = &buffers[i];
+        size_t recorded = __atomic_load_n(&buffer->recorded, __ATOMIC_ACQUIRE);
+        size_t oldest = recorded > capacity ? recorded - capacity : 0;
+        dropped += oldest;
+        for (size_t e = oldest; e < recorded; e++) {
+            trace_write_event(output_stream, pid, &buffer->events[e % capacity], first);
+            first = false;
+        }
+    }
+    fprintf(output_stream, "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_events\":%lu}}\n", dropped);
+    fclose(output_stream);
+
+    if (dropped > 0) {
+        WARN("Trace ring buffers overflowed, %lu oldest events were dropped\n", dropped);
+    }
+    INFO("Trace written to %s\n", trace_path);
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Timeline of populate calls and benchmark phases, written out as a Chrome
+// trace (also readable by Perfetto) when the process exits. Every thread
+// records into a ring buffer of its own, so recording takes no locks and no
+// I/O; when a buffer fills up the oldest events are overwritten and counted
+// as dropped. A thread's buffer goes to the next new thread once it exits,
+// so only TRACE_MAX_THREADS threads alive at once can record. Nothing is
+// recorded unless trace_start was called.
+
+#define TRACE_MAX_THREADS 256
+
+// Starts recording; the trace is written to `path` at exit, or by an
+// explicit trace_flush. `capacity` is the number of events kept per thread.
+void trace_start(const char *path, size_t capacity);
+bool trace_enabled();
+
+// Timestamps come from current_time_in_ns.
+void trace_populate(const char *backend, const void *object, uintptr_t start, uintptr_t end,
+                    uint64_t start_time, uint64_t end_time);
+void trace_phase(const char *phase, size_t repetition, uint64_t start_time, uint64_t end_time);
+
+// Names the calling thread in the trace viewer.
+void trace_thread_name(const char *name);
+
+void trace_flush();
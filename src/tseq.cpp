@@ -0,0 +1,137 @@
+#include "tseq.h"
+
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "random.h"
+#include "timing.h"
+#include "logging.h"
+
+#include "typed_seq.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+// The element type was checked when the arguments were parsed.
+static SeqType tseq_type(Arguments *config) {
+    SeqType type = SEQ_INT64;
+    seq_type_parse(config->element, &type);
+    return type;
+}
+
+static TypedSeq tseq_data(Arguments *config) {
+    return typed_seq_from_length(tseq_type(config), 1, config->size, 2);
+}
+
+// Creation and cleanup
+void *ufo_tseq_creation(Arguments *config, AnySystem system) {
+    return typed_seq_ufo_new((UfoCore *) system, tseq_data(config), !config_has_writes(config), config->min_load);
+}
+void ufo_tseq_cleanup(Arguments *config, AnySystem system, AnyObject object) {
+    typed_seq_ufo_free((UfoCore *) system, object);
+}
+
+void *ny_tseq_creation(Arguments *config, AnySystem system) {
+    return (void *) typed_seq_nyc_new((NycCore *) system, tseq_data(config), config->min_load);
+}
+void ny_tseq_cleanup(Arguments *config, AnySystem system, AnyObject object) {
+    typed_seq_nyc_free((NycCore *) system, (Borough *) object);
+}
+
+void *toronto_tseq_creation(Arguments *config, AnySystem system) {
+    return (void *) typed_seq_toronto_new((TorontoCore *) system, tseq_data(config), config->min_load);
+}
+void toronto_tseq_cleanup(Arguments *config, AnySystem system, AnyObject object) {
+    typed_seq_toronto_free((TorontoCore *) system, (Village *) object);
+}
+
+void *normil_tseq_creation(Arguments *config, AnySystem system) {
+    return typed_seq_normil_new(tseq_data(config));
+}
+void normil_tseq_cleanup(Arguments *config, AnySystem system, AnyObject object) {
+    typed_seq_normil_free(object);
+}
+
+// Execution
+// How the execution gets at the elements of each kind of object.
+template <typename T>
+struct ArrayElements {
+    T *data;
+    ArrayElements(AnyObject object): data((T *) object) {}
+    T read(size_t index) { return data[index]; }
+    void write(size_t index, T value) { data[index] = value; }
+};
+
+template <typename T>
+struct BoroughElements {
+    Borough *borough;
+    BoroughElements(AnyObject object): borough((Borough *) object) {}
+    T read(size_t index) { T value; borough_read(borough, index, &value); return value; }
+    void write(size_t index, T value) { borough_write(borough, index, &value); }
+};
+
+template <typename T>
+struct VillageElements {
+    Village *village;
+    VillageElements(AnyObject object): village((Village *) object) {}
+    T read(size_t index) { T value; village_read(village, index, &value); return value; }
+    void write(size_t index, T value) { village_write(village, index, &value); }
+};
+
+// The same loop as seq_execution, for elements of type T.
+template <typename T, typename Elements>
+static void tseq_execute(Elements elements, Arguments *config, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
+    T sum = 0;
+    SequenceBatch batch;
+    while (next(config, sequence, &batch) > 0) {
+        for (size_t i = 0; i < batch.length; i++) {
+            uint64_t start_time = Histogram_tick(latencies) ? current_time_in_ns() : 0;
+            if (batch.access[i] == ACCESS_READ) {
+                sum += elements.read(batch.current[i]);
+            } else if (batch.access[i] == ACCESS_WRITE) {
+                elements.write(batch.current[i], (T) random_int(1000));
+            } else {
+                T value = elements.read(batch.current[i]);
+                sum += value;
+                elements.write(batch.current[i], (T) (value + 1));
+            }
+            if (start_time != 0) {
+                Histogram_record(latencies, current_time_in_ns() - start_time);
+            }
+        }
+    }
+    // The bits of the sum, so that a floating point sum does not need to fit.
+    int64_t bits = 0;
+    memcpy(&bits, &sum, sizeof(T));
+    *oubliette = bits;
+}
+
+template <template <typename> class Elements>
+static void tseq_execute_typed(AnyObject object, Arguments *config, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
+    switch (tseq_type(config)) {
+        case SEQ_INT8:   tseq_execute<int8_t>  (Elements<int8_t>(object), config, sequence, next, latencies, oubliette); break;
+        case SEQ_UINT8:  tseq_execute<uint8_t> (Elements<uint8_t>(object), config, sequence, next, latencies, oubliette); break;
+        case SEQ_INT16:  tseq_execute<int16_t> (Elements<int16_t>(object), config, sequence, next, latencies, oubliette); break;
+        case SEQ_UINT16: tseq_execute<uint16_t>(Elements<uint16_t>(object), config, sequence, next, latencies, oubliette); break;
+        case SEQ_INT32:  tseq_execute<int32_t> (Elements<int32_t>(object), config, sequence, next, latencies, oubliette); break;
+        case SEQ_UINT32: tseq_execute<uint32_t>(Elements<uint32_t>(object), config, sequence, next, latencies, oubliette); break;
+        case SEQ_INT64:  tseq_execute<int64_t> (Elements<int64_t>(object), config, sequence, next, latencies, oubliette); break;
+        case SEQ_UINT64: tseq_execute<uint64_t>(Elements<uint64_t>(object), config, sequence, next, latencies, oubliette); break;
+        case SEQ_FLOAT:  tseq_execute<float>   (Elements<float>(object), config, sequence, next, latencies, oubliette); break;
+        case SEQ_DOUBLE: tseq_execute<double>  (Elements<double>(object), config, sequence, next, latencies, oubliette); break;
+    }
+}
+
+void tseq_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
+    tseq_execute_typed<ArrayElements>(object, config, sequence, next, latencies, oubliette);
+}
+void ny_tseq_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
+    tseq_execute_typed<BoroughElements>(object, config, sequence, next, latencies, oubliette);
+}
+void toronto_tseq_execution(Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette) {
+    tseq_execute_typed<VillageElements>(object, config, sequence, next, latencies, oubliette);
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "bench.h"
+
+// The tseq benchmark: a sequence like seq's, 1, 3, 5, ..., of the element
+// type given by --element.
+
+void *ufo_tseq_creation      (Arguments *config, AnySystem system);
+void *ny_tseq_creation       (Arguments *config, AnySystem system);
+void *toronto_tseq_creation  (Arguments *config, AnySystem system);
+void *normil_tseq_creation   (Arguments *config, AnySystem system);
+
+void  ufo_tseq_cleanup       (Arguments *config, AnySystem system, AnyObject object);
+void  ny_tseq_cleanup        (Arguments *config, AnySystem system, AnyObject object);
+void  toronto_tseq_cleanup   (Arguments *config, AnySystem system, AnyObject object);
+void  normil_tseq_cleanup    (Arguments *config, AnySystem system, AnyObject object);
+
+// ufo and normil objects are plain arrays and share an execution.
+void  tseq_execution         (Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette);
+void  ny_tseq_execution      (Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette);
+void  toronto_tseq_execution (Arguments *config, AnySystem system, AnyObject object, AnySequence sequence, sequence_t next, Histogram *latencies, volatile int64_t *oubliette);
+
+#ifdef __cplusplus
+}
+#endif
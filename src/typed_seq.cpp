@@ -0,0 +1,442 @@
+#include "typed_seq.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <type_traits>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "logging.h"
+#include "instrument.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+// Floating point elements have to come out the same to the last bit
+// whichever kernel fills them, so no kernel may fuse the multiply and add.
+#pragma GCC optimize ("fp-contract=off")
+
+// Chunks at least this large are filled with non-temporal stores, as in
+// seq_populate.
+#define TYPED_SEQ_STREAMING_THRESHOLD (1024UL * 1024UL)
+
+// TYPES
+typedef struct {
+    const char *name;
+    size_t size;
+    bool real;
+} SeqTypeInfo;
+
+static const SeqTypeInfo seq_types[] = {
+    { "int8",   sizeof(int8_t),   false },
+    { "uint8",  sizeof(uint8_t),  false },
+    { "int16",  sizeof(int16_t),  false },
+    { "uint16", sizeof(uint16_t), false },
+    { "int32",  sizeof(int32_t),  false },
+    { "uint32", sizeof(uint32_t), false },
+    { "int64",  sizeof(int64_t),  false },
+    { "uint64", sizeof(uint64_t), false },
+    { "float",  sizeof(float),    true  },
+    { "double", sizeof(double),   true  },
+};
+
+bool seq_type_parse(const char *name, SeqType *type) {
+    for (size_t i = 0; i < sizeof(seq_types) / sizeof(SeqTypeInfo); i++) {
+        if (strcmp(seq_types[i].name, name) == 0) {
+            *type = (SeqType) i;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char *seq_type_name(SeqType type) {
+    return seq_types[type].name;
+}
+
+size_t seq_type_size(SeqType type) {
+    return seq_types[type].size;
+}
+
+bool seq_type_is_real(SeqType type) {
+    return seq_types[type].real;
+}
+
+TypedSeq typed_seq_from_length(SeqType type, int64_t from, size_t length, int64_t by) {
+    if (seq_type_is_real(type)) {
+        return typed_seq_real_from_length(type, (double) from, length, (double) by);
+    }
+    TypedSeq data;
+    data.type = type;
+    data.from.integer = from;
+    data.by.integer = by;
+    data.length = length;
+    return data;
+}
+
+TypedSeq typed_seq_real_from_length(SeqType type, double from, size_t length, double by) {
+    TypedSeq data;
+    data.type = type;
+    data.from.real = from;
+    data.by.real = by;
+    data.length = length;
+    return data;
+}
+
+static bool typed_seq_check(TypedSeq *data) {
+    if (data->type == SEQ_FLOAT && data->length > INT32_MAX) {
+        REPORT("A float sequence can have at most %d elements, not %lu\n", INT32_MAX, data->length);
+        return false;
+    }
+    return true;
+}
+
+// GENERATORS
+// Element `index` of a sequence. Integers are computed modulo 2^64 and then
+// truncated, which is the same as computing them in their own width.
+template <typename T>
+static inline T typed_seq_element(T from, T by, size_t index) {
+    if constexpr (std::is_same<T, float>::value) {
+        return from + by * (float) (int32_t) index;
+    } else if constexpr (std::is_floating_point<T>::value) {
+        return from + by * (T) index;
+    } else {
+        return (T) ((uint64_t) from + (uint64_t) by * (uint64_t) index);
+    }
+}
+
+// Produces the elements of a sequence W bytes at a time, starting from
+// element `index`. Integer lanes each step by lanes * by, so there is no
+// multiply per element.
+template <typename T, size_t W, bool Real = std::is_floating_point<T>::value>
+struct Generator;
+
+template <typename T, size_t W>
+struct Generator<T, W, false> {
+    typedef typename std::make_unsigned<T>::type U;
+    typedef U Vector __attribute__((vector_size(W)));
+    static const size_t lanes = W / sizeof(T);
+
+    Vector values;
+    Vector step;
+
+    Generator(T from, T by, size_t index) {
+        for (size_t k = 0; k < lanes; k++) {
+            values[k] = (U) typed_seq_element(from, by, index + k);
+            step[k] = (U) ((uint64_t) by * lanes);
+        }
+    }
+    __attribute__((always_inline)) void next(Vector *current) {
+        *current = values;
+        values += step;
+    }
+};
+
+// Floating point lanes are computed from their indices, which count exactly:
+// as int32 for float, so that there are as many of them as floats, and as
+// double for double.
+template <typename T, size_t W>
+struct Generator<T, W, true> {
+    typedef typename std::conditional<std::is_same<T, float>::value, int32_t, double>::type I;
+    typedef T Vector __attribute__((vector_size(W)));
+    typedef I Indices __attribute__((vector_size(W)));
+    static const size_t lanes = W / sizeof(T);
+
+    Vector from;
+    Vector by;
+    Indices indices;
+    Indices step;
+
+    Generator(T from_, T by_, size_t index) {
+        for (size_t k = 0; k < lanes; k++) {
+            from[k] = from_;
+            by[k] = by_;
+            indices[k] = (I) (index + k);
+            step[k] = (I) lanes;
+        }
+    }
+    __attribute__((always_inline)) void next(Vector *current) {
+        *current = from + by * __builtin_convertvector(indices, Vector);
+        indices += step;
+    }
+};
+
+// KERNELS
+template <typename T>
+static void typed_seq_fill_scalar(T *target, size_t count, T from, T by, size_t index) {
+    if constexpr (std::is_floating_point<T>::value) {
+        for (size_t i = 0; i < count; i++) {
+            target[i] = typed_seq_element(from, by, index + i);
+        }
+    } else {
+        typedef typename std::make_unsigned<T>::type U;
+        U value = (U) typed_seq_element(from, by, index);
+        for (size_t i = 0; i < count; i++) {
+            target[i] = (T) value;
+            value += (U) by;
+        }
+    }
+}
+
+#if defined(__x86_64__)
+// As in seq_populate: a scalar head up to the first vector boundary, aligned
+// vector stores, and a scalar tail.
+template <typename T>
+__attribute__((target("avx2")))
+static void typed_seq_fill_avx2(T *target, size_t count, T from, T by, size_t index) {
+    typedef Generator<T, 32> G;
+    size_t i = 0;
+    for (; i < count && ((uintptr_t) (target + i) & 31) != 0; i++) {
+        target[i] = typed_seq_element(from, by, index + i);
+    }
+    size_t vectors_end = i + (count - i) / G::lanes * G::lanes;
+    G generator(from, by, index + i);
+    typename G::Vector current;
+    if ((vectors_end - i) * sizeof(T) >= TYPED_SEQ_STREAMING_THRESHOLD) {
+        for (; i < vectors_end; i += G::lanes) {
+            generator.next(&current);
+            _mm256_stream_si256((__m256i *) (target + i), (__m256i) current);
+        }
+        _mm_sfence();
+    } else {
+        for (; i < vectors_end; i += G::lanes) {
+            generator.next(&current);
+            _mm256_store_si256((__m256i *) (target + i), (__m256i) current);
+        }
+    }
+    typed_seq_fill_scalar(target + i, count - i, from, by, index + i);
+}
+
+template <typename T>
+__attribute__((target("avx512f,avx512bw")))
+static void typed_seq_fill_avx512(T *target, size_t count, T from, T by, size_t index) {
+    typedef Generator<T, 64> G;
+    size_t i = 0;
+    for (; i < count && ((uintptr_t) (target + i) & 63) != 0; i++) {
+        target[i] = typed_seq_element(from, by, index + i);
+    }
+    size_t vectors_end = i + (count - i) / G::lanes * G::lanes;
+    G generator(from, by, index + i);
+    typename G::Vector current;
+    if ((vectors_end - i) * sizeof(T) >= TYPED_SEQ_STREAMING_THRESHOLD) {
+        for (; i < vectors_end; i += G::lanes) {
+            generator.next(&current);
+            _mm512_stream_si512((__m512i *) (target + i), (__m512i) current);
+        }
+        _mm_sfence();
+    } else {
+        for (; i < vectors_end; i += G::lanes) {
+            generator.next(&current);
+            _mm512_store_si512((__m512i *) (target + i), (__m512i) current);
+        }
+    }
+    typed_seq_fill_scalar(target + i, count - i, from, by, index + i);
+}
+#endif
+
+typedef enum {
+    KERNEL_SCALAR,
+    KERNEL_AVX2,
+    KERNEL_AVX512,
+} Kernel;
+
+// The widest kernel the CPU supports, picked once, before main.
+static Kernel typed_seq_kernel_select() {
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        return KERNEL_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return KERNEL_AVX2;
+    }
+#endif
+    return KERNEL_SCALAR;
+}
+
+static const Kernel typed_seq_kernel = typed_seq_kernel_select();
+
+// One populate per element type and kernel, so that a call goes straight to
+// its fill loop without looking at the type or the CPU again.
+template <typename T, Kernel K>
+static int32_t typed_seq_populate_t(void* user_data, uintptr_t start, uintptr_t end, unsigned char* target_bytes) {
+    const TypedSeq *data = (const TypedSeq *) user_data;
+    T from = std::is_floating_point<T>::value ? (T) data->from.real : (T) data->from.integer;
+    T by = std::is_floating_point<T>::value ? (T) data->by.real : (T) data->by.integer;
+    T *target = (T *) target_bytes;
+    if constexpr (K == KERNEL_SCALAR) {
+        typed_seq_fill_scalar(target, end - start, from, by, start);
+    }
+#if defined(__x86_64__)
+    else if constexpr (K == KERNEL_AVX2) {
+        typed_seq_fill_avx2(target, end - start, from, by, start);
+    } else if constexpr (K == KERNEL_AVX512) {
+        typed_seq_fill_avx512(target, end - start, from, by, start);
+    }
+#endif
+    return 0;
+}
+
+#define TYPED_SEQ_POPULATES(K) {                                                   \
+    typed_seq_populate_t<int8_t, K>,  typed_seq_populate_t<uint8_t, K>,           \
+    typed_seq_populate_t<int16_t, K>, typed_seq_populate_t<uint16_t, K>,          \
+    typed_seq_populate_t<int32_t, K>, typed_seq_populate_t<uint32_t, K>,          \
+    typed_seq_populate_t<int64_t, K>, typed_seq_populate_t<uint64_t, K>,          \
+    typed_seq_populate_t<float, K>,   typed_seq_populate_t<double, K>,            \
+}
+
+// Indexed by Kernel, then by SeqType.
+static const TypedSeqPopulate typed_seq_populates[][SEQ_DOUBLE + 1] = {
+    TYPED_SEQ_POPULATES(KERNEL_SCALAR),
+#if defined(__x86_64__)
+    TYPED_SEQ_POPULATES(KERNEL_AVX2),
+    TYPED_SEQ_POPULATES(KERNEL_AVX512),
+#endif
+};
+
+TypedSeqPopulate typed_seq_populate_of(SeqType type) {
+    return typed_seq_populates[typed_seq_kernel][type];
+}
+
+int32_t typed_seq_populate(void* user_data, uintptr_t start, uintptr_t end, unsigned char* target_bytes) {
+    TypedSeq *data = (TypedSeq *) user_data;
+    return typed_seq_populate_of(data->type)(user_data, start, end, target_bytes);
+}
+
+// UFO
+void *typed_seq_ufo_new(UfoCore *ufo_system, TypedSeq seq, bool read_only, size_t min_load_count) {
+    if (!typed_seq_check(&seq)) {
+        return NULL;
+    }
+    TypedSeq *data = (TypedSeq *) malloc(sizeof(TypedSeq));
+    *data = seq;
+
+    UfoParameters parameters;
+    parameters.header_size = 0;
+    parameters.element_size = seq_type_size(data->type);
+    parameters.element_ct = data->length;
+    parameters.min_load_ct = min_load_count;
+    parameters.read_only = read_only;
+    parameters.populate_data = data;
+    parameters.populate_fn = typed_seq_populate_of(data->type);
+    INSTRUMENT_PARAMETERS(parameters, "ufo");
+
+    UfoObj ufo_object = ufo_new_object(ufo_system, &parameters);
+    if (ufo_is_error(&ufo_object)) {
+        fprintf(stderr, "Cannot create UFO object.\n");
+        return NULL;
+    }
+
+    return ufo_header_ptr(&ufo_object);
+}
+
+void typed_seq_ufo_free(UfoCore *ufo_system, void *ptr) {
+    UfoObj ufo_object = ufo_get_by_address(ufo_system, ptr);
+    if (ufo_is_error(&ufo_object)) {
+        fprintf(stderr, "Cannot free %p: not a UFO object.\n", ptr);
+        return;
+    }
+
+    UfoParameters parameters;
+    int result = ufo_get_params(ufo_system, &ufo_object, &parameters);
+    if (result < 0) {
+        REPORT("Unable to access UFO parameters, so cannot free sequence data\n");
+    }
+    UNINSTRUMENT_PARAMETERS(parameters);
+    free(parameters.populate_data);
+
+    ufo_free(ufo_object);
+}
+
+// Normil
+void *typed_seq_normil_new(TypedSeq data) {
+    if (!typed_seq_check(&data)) {
+        return NULL;
+    }
+    void *target = malloc(seq_type_size(data.type) * data.length);
+    typed_seq_populate_of(data.type)(&data, 0, data.length, (unsigned char *) target);
+    return target;
+}
+
+void typed_seq_normil_free(void *ptr) {
+    free(ptr);
+}
+
+// NYC
+Borough *typed_seq_nyc_new(NycCore *system, TypedSeq seq, size_t min_load_count) {
+    if (!typed_seq_check(&seq)) {
+        return NULL;
+    }
+    TypedSeq *data = (TypedSeq *) malloc(sizeof(TypedSeq));
+    *data = seq;
+
+    BoroughParameters parameters;
+    parameters.header_size = 0;
+    parameters.element_size = seq_type_size(data->type);
+    parameters.element_ct = data->length;
+    parameters.min_load_ct = min_load_count;
+    parameters.populate_data = data;
+    parameters.populate_fn = typed_seq_populate_of(data->type);
+    INSTRUMENT_PARAMETERS(parameters, "nyc");
+
+    Borough *object = (Borough *) malloc(sizeof(Borough));
+    *object = nyc_new_borough(system, &parameters);
+    if (borough_is_error(object)) {
+        fprintf(stderr, "Cannot create NYC object.\n");
+        return NULL;
+    }
+
+    return object;
+}
+
+void typed_seq_nyc_free(NycCore *system, Borough *object) {
+    BoroughParameters parameters;
+    borough_params(object, &parameters);
+    UNINSTRUMENT_PARAMETERS(parameters);
+    free(parameters.populate_data);
+    borough_free(*object);
+    free(object);
+}
+
+// Toronto
+Village *typed_seq_toronto_new(TorontoCore *system, TypedSeq seq, size_t min_load_count) {
+    if (!typed_seq_check(&seq)) {
+        return NULL;
+    }
+    TypedSeq *data = (TypedSeq *) malloc(sizeof(TypedSeq));
+    *data = seq;
+
+    VillageParameters parameters;
+    parameters.header_size = 0;
+    parameters.element_size = seq_type_size(data->type);
+    parameters.element_ct = data->length;
+    parameters.min_load_ct = min_load_count;
+    parameters.populate_data = data;
+    parameters.populate_fn = typed_seq_populate_of(data->type);
+    INSTRUMENT_PARAMETERS(parameters, "toronto");
+
+    Village *object = (Village *) malloc(sizeof(Village));
+    *object = toronto_new_village(system, &parameters);
+    if (village_is_error(object)) {
+        fprintf(stderr, "Cannot create Toronto object.\n");
+        return NULL;
+    }
+
+    return object;
+}
+
+void typed_seq_toronto_free(TorontoCore *system, Village *object) {
+    VillageParameters parameters;
+    village_params(object, &parameters);
+    UNINSTRUMENT_PARAMETERS(parameters);
+    free(parameters.populate_data);
+    village_free(*object);
+    free(object);
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ufo_c/target/ufo_c.h"
+#include "new_york/target/nyc.h"
+#include "toronto/target/toronto.h"
+
+// Arithmetic sequences of any element type: from, from + by, from + 2 * by,
+// ... The populate functions are templates instantiated for each type and
+// each vector width; objects get the one for their type and the CPU when
+// they are created.
+//
+// Integer elements wrap around at the width of their type, so a negative
+// step counts down, in unsigned types too. Floating point elements are
+// computed as from + by * i, so the error does not grow along the sequence.
+// float sequences are limited to INT32_MAX elements.
+typedef enum {
+    SEQ_INT8,
+    SEQ_UINT8,
+    SEQ_INT16,
+    SEQ_UINT16,
+    SEQ_INT32,
+    SEQ_UINT32,
+    SEQ_INT64,
+    SEQ_UINT64,
+    SEQ_FLOAT,
+    SEQ_DOUBLE,
+} SeqType;
+
+// Integer sequences use `integer`, truncated to the element type, and
+// floating point sequences use `real`.
+typedef union {
+    int64_t integer;
+    double real;
+} SeqValue;
+
+typedef struct {
+    SeqType type;
+    SeqValue from;
+    SeqValue by;
+    size_t length;
+} TypedSeq;
+
+bool seq_type_parse(const char *name, SeqType *type);
+const char *seq_type_name(SeqType type);
+size_t seq_type_size(SeqType type);
+bool seq_type_is_real(SeqType type);
+
+// Integer from and by are converted for floating point types.
+TypedSeq typed_seq_from_length(SeqType type, int64_t from, size_t length, int64_t by);
+TypedSeq typed_seq_real_from_length(SeqType type, double from, size_t length, double by);
+
+typedef int32_t (*TypedSeqPopulate)(void* user_data, uintptr_t start, uintptr_t end, unsigned char* target_bytes);
+
+// The populate function of sequences of the type, for the widest kernel the
+// CPU supports.
+TypedSeqPopulate typed_seq_populate_of(SeqType type);
+
+// Looks up the populate function of data->type on every call.
+int32_t typed_seq_populate(void* user_data, uintptr_t start, uintptr_t end, unsigned char* target_bytes);
+
+void *typed_seq_ufo_new(UfoCore *ufo_system, TypedSeq data, bool read_only, size_t min_load_count);
+void typed_seq_ufo_free(UfoCore *ufo_system, void *ptr);
+
+void *typed_seq_normil_new(TypedSeq data);
+void typed_seq_normil_free(void *ptr);
+
+Borough *typed_seq_nyc_new(NycCore *system, TypedSeq data, size_t min_load_count);
+void typed_seq_nyc_free(NycCore *system, Borough *object);
+
+Village *typed_seq_toronto_new(TorontoCore *system, TypedSeq data, size_t min_load_count);
+void typed_seq_toronto_free(TorontoCore *system, Village *object);
+
+#ifdef __cplusplus
+}
+#endif
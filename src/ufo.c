@@ -10,6 +10,7 @@
 #include "col.h"
 
 #include "logging.h"
+#include "instrument.h"
 
 void *ufo_setup(Arguments *config) {
     UfoCore ufo_system = ufo_new_core("/tmp/", config->high_water_mark, config->low_water_mark);
@@ -31,7 +32,7 @@ void ufo_teardown(Arguments *config, AnySystem system) {
 // Fib
 void *ufo_fib_creation(Arguments *config, AnySystem system) {
     UfoCore *ufo_system_ptr = (UfoCore *) system;
-    return (void *) ufo_fib_new(ufo_system_ptr, config->size, config->writes == 0, config->min_load);
+    return (void *) ufo_fib_new(ufo_system_ptr, config->size, config->fib_mode, !config_has_writes(config), config->min_load);
 }
 
 void ufo_fib_cleanup(Arguments *config, AnySystem system, AnyObject object) {
@@ -42,7 +43,7 @@ void ufo_fib_cleanup(Arguments *config, AnySystem system, AnyObject object) {
 // BZip
 void *ufo_bzip_creation(Arguments *config, AnySystem system) {
     UfoCore *ufo_system_ptr = (UfoCore *) system;
-    return (void *) BZip2_ufo_new(ufo_system_ptr, config->file, config->writes == 0, config->min_load);
+    return (void *) BZip2_ufo_new(ufo_system_ptr, config->file, !config_has_writes(config), config->min_load);
 }
 
 void ufo_bzip_cleanup(Arguments *config, AnySystem system, AnyObject object) {
@@ -53,7 +54,7 @@ void ufo_bzip_cleanup(Arguments *config, AnySystem system, AnyObject object) {
 // Seq
 void *ufo_seq_creation(Arguments *config, AnySystem system) {
     UfoCore *ufo_system_ptr = (UfoCore *) system;
-    return (void *) seq_ufo_from_length(ufo_system_ptr, 1, config->size, 2, config->writes == 0, config->min_load);
+    return (void *) seq_ufo_from_length(ufo_system_ptr, 1, config->size, 2, !config_has_writes(config), config->min_load);
 }
 void ufo_seq_cleanup(Arguments *config, AnySystem system, AnyObject object) {
     UfoCore *ufo_system_ptr = (UfoCore *) system;
@@ -63,7 +64,7 @@ void ufo_seq_cleanup(Arguments *config, AnySystem system, AnyObject object) {
 // Psql
 void *ufo_psql_creation(Arguments *config, AnySystem system) {
     UfoCore *ufo_system_ptr = (UfoCore *) system;
-    return (void *) Players_ufo_new(ufo_system_ptr, config->writes == 0, config->min_load);
+    return (void *) Players_ufo_new(ufo_system_ptr, !config_has_writes(config), config->min_load);
 }
 void ufo_psql_cleanup(Arguments *config, AnySystem system, AnyObject object) {
     UfoCore *ufo_system_ptr = (UfoCore *) system;
@@ -73,7 +74,7 @@ void ufo_psql_cleanup(Arguments *config, AnySystem system, AnyObject object) {
 // MMap
 void *ufo_mmap_creation(Arguments *config, AnySystem system) {
     UfoCore *ufo_system_ptr = (UfoCore *) system;
-    return (void *) MMap_ufo_new(ufo_system_ptr, config->file,  toupper, config->writes == 0, config->min_load);
+    return (void *) MMap_ufo_new(ufo_system_ptr, config->file,  toupper, !config_has_writes(config), config->min_load);
 }
 void ufo_mmap_cleanup(Arguments *config, AnySystem system, AnyObject object) {
     UfoCore *ufo_system_ptr = (UfoCore *) system;
@@ -84,7 +85,7 @@ void ufo_mmap_cleanup(Arguments *config, AnySystem system, AnyObject object) {
 void *ufo_col_creation(Arguments *config, AnySystem system) {
     UfoCore *ufo_system_ptr = (UfoCore *) system;
     int32_t **matrix = col_source_matrix_new(config->size, COL_COLUMNS_IN_EACH_ROW);
-    return (void *) col_ufo_new(ufo_system_ptr, matrix, COL_SELECTED_COLUMN, config->size, config->writes == 0, config->min_load);
+    return (void *) col_ufo_new(ufo_system_ptr, matrix, COL_SELECTED_COLUMN, config->size, !config_has_writes(config), config->min_load);
 }
 void ufo_col_cleanup(Arguments *config, AnySystem system, AnyObject object) {
     UfoCore *ufo_system = (UfoCore *) system;
@@ -100,8 +101,20 @@ void ufo_col_cleanup(Arguments *config, AnySystem system, AnyObject object) {
     if (result < 0) {
         REPORT("Unable to access UFO parameters, so cannot free source matrix\n");
     }
-    ColumnSpec *spec = (ColumnSpec *) parameters.populate_data;
+    ColumnSpec *spec = (ColumnSpec *) INSTRUMENTED_DATA(parameters);
     col_source_matrix_free(spec->source, spec->size);
 
     col_ufo_free(ufo_system, object);   
-}
\ No newline at end of file
+}
+
+// Address lookup
+void *ufo_lookup_creation(Arguments *config, AnySystem system, size_t size) {
+    UfoCore *ufo_system_ptr = (UfoCore *) system;
+    return (void *) seq_ufo_from_length(ufo_system_ptr, 1, size, 2, true, config->min_load);
+}
+
+bool ufo_lookup(AnySystem system, void *address) {
+    UfoCore *ufo_system_ptr = (UfoCore *) system;
+    UfoObj ufo_object = ufo_get_by_address(ufo_system_ptr, address);
+    return !ufo_is_error(&ufo_object);
+}
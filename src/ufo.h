@@ -19,3 +19,7 @@ void ufo_psql_cleanup(Arguments *config, AnySystem system, AnyObject object);
 void ufo_mmap_cleanup(Arguments *config, AnySystem system, AnyObject object);
 void ufo_col_cleanup(Arguments *config, AnySystem system, AnyObject object);
 
+
+// Address lookup
+void *ufo_lookup_creation(Arguments *config, AnySystem system, size_t size);
+bool ufo_lookup(AnySystem system, void *address);